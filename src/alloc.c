@@ -8,8 +8,21 @@
  * Key modernizations: ANSI C function signatures, enhanced type safety
  */
 
+#include <stdlib.h> /* MODERN: first, before config.h can rename free() */
+#include <stddef.h>
 #include "hack.h"
-#include <stdlib.h>
+#include <string.h>
+#ifdef ALLOC_STATS
+#include <signal.h>
+#include <stdio.h>
+#include <unistd.h>
+#undef alloc /* MODERN: the functions themselves, see config.h */
+#undef lalloc
+#undef enlarge
+#undef free
+extern void *alloc(unsigned lth);
+extern void *enlarge(char *ptr, unsigned lth);
+#endif /* ALLOC_STATS */
 
 #ifdef LINT
 
@@ -72,9 +85,12 @@ unsigned lth;
  * PRESERVES: Identical allocation behavior and error handling via panic()
  * ADDS: Type safety and ANSI C compliance without casting requirements
  */
+long alloc_calls; /* MODERN: alloc() and enlarge() calls, for hack-bench */
+
 void *alloc(unsigned lth) {
   char *ptr;
 
+  alloc_calls++;
   if (!(ptr = malloc(lth)))
     panic("Cannot get %d bytes", lth);
   return (ptr);
@@ -83,9 +99,513 @@ void *alloc(unsigned lth) {
 void *enlarge(char *ptr, unsigned lth) {
   char *nptr;
 
+  alloc_calls++;
   if (!(nptr = realloc(ptr, lth)))
     panic("Cannot reallocate %d bytes", lth);
   return (nptr);
 }
 
+#ifdef ALLOC_STATS
+/*
+ * MODERN ADDITION (2026): Allocation accounting per call site
+ *
+ * WHY: Hundreds of games run side by side on one host, and nothing told
+ * which part of the game held a process's memory or what it never gave
+ * back.
+ *
+ * HOW: Built with ALLOC_STATS (cmake -DENABLE_ALLOC_STATS=ON), config.h
+ * turns every alloc(), lalloc() and enlarge() into a call naming its file
+ * and line, and free() into afree(). A block from alloc() carries its
+ * site and size in a header in front of it; a level arena block keeps its
+ * site in the arena's header. Each site counts its allocations, its live
+ * blocks and bytes, and the most bytes it ever held.
+ *
+ * The table is appended to ALLOCLOG in the playground, each line tagged
+ * with the process id: when the process exits (done(), a save, a hangup),
+ * and after the next command once it has been sent SIGUSR1. What is still
+ * live at exit is what the game never freed.
+ *
+ * PRESERVES: The same allocations in the same order; the headers only
+ * add bytes. Without ALLOC_STATS none of this is compiled in.
+ * ADDS: The ALLOCLOG report.
+ */
+#define ALLOCLOG "allocstats"
+#define ASITES 512 /* distinct call sites counted; a power of two */
+
+union ahdr { /* in front of a block from alloc_at() */
+  struct {
+    unsigned site; /* index in asites[] */
+    unsigned size; /* bytes asked for */
+  } a;
+  long l; /* what follows must be aligned for these */
+  double d;
+  void *p;
+};
+
+struct asite {
+  const char *site; /* "file:line" */
+  long allocs;      /* allocations made there */
+  long blocks;      /* still live */
+  long bytes;       /* in the live blocks */
+  long peak;        /* most bytes live at once */
+};
+
+/* sites hashed by the address of their name; the last slot is the rest */
+static struct asite asites[ASITES + 1] = {{0}};
+static int nasites;
+static long abytes, apeak; /* over all sites */
+static volatile sig_atomic_t allocstats_due;
+
+static void allocstats_report(void);
+
+static void allocstats_signal(int sig) {
+  (void)sig;
+  allocstats_due = 1; /* check_allocstats() writes the report */
+  (void)signal(SIGUSR1, allocstats_signal);
+}
+
+static unsigned asite_of(const char *site) {
+  unsigned i = (unsigned)((unsigned long)site >> 3) & (ASITES - 1);
+
+  while (asites[i].site != site) {
+    if (!asites[i].site) {
+      if (nasites == ASITES / 2) { /* keep the probes short */
+        asites[ASITES].site = "(other sites)";
+        return (ASITES);
+      }
+      if (!nasites++) {
+        (void)signal(SIGUSR1, allocstats_signal);
+        (void)atexit(allocstats_report);
+      }
+      asites[i].site = site;
+      break;
+    }
+    i = (i + 1) & (ASITES - 1);
+  }
+  return (i);
+}
+
+static void acount(unsigned i, long bytes) {
+  struct asite *as = &asites[i];
+
+  as->allocs++;
+  as->blocks++;
+  if ((as->bytes += bytes) > as->peak)
+    as->peak = as->bytes;
+  if ((abytes += bytes) > apeak)
+    apeak = abytes;
+}
+
+static void adrop(unsigned i, long bytes) {
+  asites[i].blocks--;
+  asites[i].bytes -= bytes;
+  abytes -= bytes;
+}
+
+void *alloc_at(unsigned lth, const char *site) {
+  union ahdr *h = (union ahdr *)alloc((unsigned)sizeof(union ahdr) + lth);
+
+  h->a.site = asite_of(site);
+  h->a.size = lth;
+  acount(h->a.site, (long)lth);
+  return (h + 1);
+}
+
+void *enlarge_at(char *ptr, unsigned lth, const char *site) {
+  union ahdr *h;
+
+  if (!ptr)
+    return (alloc_at(lth, site));
+  h = (union ahdr *)ptr - 1;
+  adrop(h->a.site, (long)h->a.size);
+  h = (union ahdr *)enlarge((char *)h, (unsigned)sizeof(union ahdr) + lth);
+  h->a.site = asite_of(site);
+  h->a.size = lth;
+  acount(h->a.site, (long)lth);
+  return (h + 1);
+}
+
+void afree(void *ptr) {
+  union ahdr *h;
+
+  if (!ptr)
+    return;
+  h = (union ahdr *)ptr - 1;
+  adrop(h->a.site, (long)h->a.size);
+  free((char *)h);
+}
+
+static int asite_cmp(const void *a, const void *b) {
+  const struct asite *x = *(const struct asite *const *)a;
+  const struct asite *y = *(const struct asite *const *)b;
+
+  if (x->bytes != y->bytes)
+    return (x->bytes < y->bytes ? 1 : -1);
+  return (x->peak < y->peak ? 1 : x->peak > y->peak ? -1 : 0);
+}
+
+static void allocstats_report(void) {
+  struct asite *tab[ASITES + 1];
+  const char *name;
+  FILE *fp;
+  int i, n = 0, pid = (int)getpid();
+
+  if (!(fp = fopen(ALLOCLOG, "a")))
+    return;
+  for (i = 0; i <= ASITES; i++)
+    if (asites[i].site)
+      tab[n++] = &asites[i];
+  qsort((char *)tab, (size_t)n, sizeof(tab[0]), asite_cmp);
+  fprintf(fp, "%d: %ld bytes live, %ld at most, from %d sites\n", pid,
+          abytes, apeak, n);
+  fprintf(fp, "%d: %10s %7s %9s %10s  %s\n", pid, "live bytes", "blocks",
+          "allocs", "peak", "site");
+  for (i = 0; i < n; i++) {
+    name = (name = strrchr(tab[i]->site, '/')) ? name + 1 : tab[i]->site;
+    fprintf(fp, "%d: %10ld %7ld %9ld %10ld  %s\n", pid, tab[i]->bytes,
+            tab[i]->blocks, tab[i]->allocs, tab[i]->peak, name);
+  }
+  (void)fclose(fp);
+}
+
+/* called once a command: write the report SIGUSR1 asked for */
+void check_allocstats(void) {
+  if (allocstats_due) {
+    allocstats_due = 0;
+    allocstats_report();
+  }
+}
+#endif /* ALLOC_STATS */
+
+/*
+ * MODERN ADDITION (2026): Per-level arenas for level entities
+ *
+ * WHY: Every monster, object, gold pile, trap, engraving and worm segment
+ * was a malloc() of its own, and storing a level gave each one back with a
+ * free() of its own - hundreds of allocator calls per level change, and a
+ * heap fragmented by the leftovers of every level visited.
+ *
+ * HOW: newmonst(), newobj(), newgold(), newtrap(), newseg() and the
+ * engravings take their memory with lalloc() from the arena of the level
+ * they are made on (dlevel): 16 KB chunks handed out by bumping a pointer,
+ * each block headed by its chunk. lfree() counts a block as dead and keeps
+ * it for reuse (see the pools below). When savelev() has written a level
+ * and let go of its chains, arena_release() frees the level's chunks in
+ * one pass.
+ *
+ * Things carried off their level - an object picked up, a pet that
+ * follows - stay where they were made: callers hold pointers to them
+ * across goto_level() (doread() uses up a scroll that has just teleported
+ * you), so they cannot be copied out. A chunk that still holds some when
+ * its level is released is handed on instead, with its dead blocks, to
+ * the next level that allocates (arena_adopt()); that level fills it
+ * before growing, so the chunks pinned by carried things never number
+ * more than the things themselves and their free space is used again.
+ *
+ * PRESERVES: Entities are plain structs with the same lifetimes; nothing
+ * moves, so no pointer to one changes. Blocks too big for a chunk, and
+ * anything made outside the dungeon's levels, come from malloc().
+ * ADDS: One malloc() per 16 KB of level; one free() per chunk when a
+ * level is stored. #stats reports the arenas.
+ */
+#define LCHUNK 16384
+
+union lhdr { /* in front of every block */
+  struct {
+    struct lchunk *ck;    /* its chunk; 0 if it came from malloc() */
+    unsigned short units; /* its size in lhdrs, from its start */
+    unsigned short pre;   /* bytes in front of this header: a struct lchain */
+#ifdef ALLOC_STATS
+    unsigned site; /* MODERN: index in asites[] */
+#endif
+  } b;
+  long l; /* what follows must be aligned for these */
+  double d;
+  void *p;
+  char size[LHDRSZ]; /* see LBACK() in hack.h */
+};
+
+typedef char lhdr_is_lhdrsz[sizeof(union lhdr) == LHDRSZ ? 1 : -1];
+
+/*
+ * MODERN ADDITION (2026): Chain headers
+ *
+ * WHY: The back-links of hack.invent.c, the id of hack.ident.c and the
+ * order number of hack.grid.c were fields of every block's header, so an
+ * engraving or a 16-byte worm segment paid 40 bytes of header for links
+ * it never has.
+ *
+ * HOW: lalloc_chained() puts a struct lchain in front of the header of
+ * objects, monsters, gold and traps only. Gold and traps, which have no
+ * id, take just its last two fields, the pointers LHEAD() and LBACK() in
+ * hack.h find right in front of the header. lfree() knows from pre what
+ * a block has.
+ *
+ * PRESERVES: The entities and the accessors (LBACK(), lgetid(), lgetseq())
+ * are unchanged.
+ * ADDS: Headers of 16 bytes for engravings and worm segments, 32 for gold
+ * and traps and 40 for objects and monsters (64-bit).
+ */
+struct lchain {
+  unsigned id;  /* MODERN: filed under it in the id index; 0 if not */
+  unsigned seq; /* MODERN: objects: their place in fobj; see order_object() */
+  void *head;   /* MODERN: LHEAD(), the chain it is in; see hack.h */
+  void *back;   /* MODERN: LBACK(), the link to it; last, see hack.h */
+};
+
+#define LCHAIN(h) ((struct lchain *)(h) - 1) /* the one in front of h */
+#define LIDENT ((unsigned short)sizeof(struct lchain))
+#define LLINKS ((unsigned short)(sizeof(struct lchain) - \
+                                 offsetof(struct lchain, head)))
+
+/* LBACK() and LHEAD() in hack.h take back and head to be the two pointers
+   just in front of the header */
+typedef char lback_is_last[offsetof(struct lchain, back) + sizeof(void *) ==
+                                   sizeof(struct lchain)
+                               ? 1
+                               : -1];
+typedef char lhead_is_next[offsetof(struct lchain, head) + sizeof(void *) ==
+                                   offsetof(struct lchain, back)
+                               ? 1
+                               : -1];
+
+/*
+ * MODERN ADDITION (2026): Size-class pools in the level arenas
+ *
+ * WHY: A chunk is only freed once every block in it is dead, so on a level
+ * that lives long - monsters killed, loot dropped, stacks split and merged
+ * turn after turn - the arena kept bumping into new chunks while the dead
+ * blocks behind it sat unused.
+ *
+ * HOW: lfree() puts a dead block on its level's free list for its size
+ * class (its size in header-sized units, up to LPOOL of them) and lalloc() takes
+ * from that list before bumping. Blocks keep their class for life, so a
+ * reused block always fits. Chunks of a level in use stay until
+ * arena_release(); the free lists go with them.
+ *
+ * PRESERVES: Only the dead blocks of a stored level's chunks are handed
+ * out again, and only once the chunk has been handed on to a level in use.
+ * ADDS: Reuse and high-water counts, reported by #stats.
+ */
+#define LPOOL 64 /* largest pooled block, in lhdrs (1 KB) */
+
+struct lchunk {
+  struct lchunk *prev, *next; /* the level's chunks, newest first */
+  long live;                  /* blocks not yet lfree()d */
+  int lev;                    /* its level, or LSPARE */
+  unsigned used;              /* bytes of data[] handed out */
+  union lhdr data[LCHUNK / sizeof(union lhdr)];
+};
+
+#define LSPARE (MAXLEVEL + 1) /* chunks of stored levels still in use */
+
+static struct lchunk *arenas[LSPARE + 1];
+static union lhdr *pools[LSPARE + 1][LPOOL + 1]; /* dead blocks by size */
+long arena_chunks; /* MODERN: chunks allocated, for hack-bench */
+long arena_handed; /* MODERN: chunks handed on at the last release */
+static long arena_peakhanded, arena_blocks;
+static long arena_reused, arena_bumped, arena_peakchunks, arena_peakblocks;
+
+/* hand the chunks of stored levels still in use on to level lev */
+static void arena_adopt(int lev) {
+  struct lchunk *ck, *last = 0;
+  union lhdr *h;
+  int u;
+
+  for (ck = arenas[LSPARE]; ck; ck = ck->next) {
+    ck->lev = lev;
+    last = ck;
+  }
+  /* behind the chunk being bumped, if the level has one */
+  if ((ck = arenas[lev])) {
+    if ((last->next = ck->next))
+      last->next->prev = last;
+    ck->next = arenas[LSPARE];
+    arenas[LSPARE]->prev = ck;
+  } else
+    arenas[lev] = arenas[LSPARE];
+  arenas[LSPARE] = 0;
+  for (u = 1; u <= LPOOL; u++) {
+    if (!(h = pools[LSPARE][u]))
+      continue;
+    while (h[1].p)
+      h = (union lhdr *)h[1].p;
+    h[1].p = pools[lev][u];
+    pools[lev][u] = pools[LSPARE][u];
+    pools[LSPARE][u] = 0;
+  }
+}
+
+/* a block of lth bytes, with pre bytes of struct lchain in front of it */
+#ifdef ALLOC_STATS
+static void *lget(unsigned pre, unsigned lth, const char *site) {
+#else
+static void *lget(unsigned pre, unsigned lth) {
+#endif
+  unsigned units = (unsigned)((pre + LHDRSZ + lth + LHDRSZ - 1) / LHDRSZ);
+  unsigned need = units * LHDRSZ;
+  struct lchunk *ck;
+  union lhdr *h;
+  char *start;
+  int lev = dlevel;
+
+  if (lev < 0 || lev > MAXLEVEL || need > LCHUNK / 4) {
+#ifdef ALLOC_STATS
+    start = (char *)alloc_at(pre + LHDRSZ + lth, site);
+#else
+    start = (char *)alloc(pre + LHDRSZ + lth);
+#endif
+    ck = 0;
+  } else {
+    if (arenas[LSPARE])
+      arena_adopt(lev);
+    if (units <= LPOOL && (h = pools[lev][units])) {
+      pools[lev][units] = (union lhdr *)h[1].p;
+      ck = h->b.ck;
+      start = (char *)h;
+      arena_reused++;
+    } else {
+      if (!(ck = arenas[lev]) || ck->used + need > LCHUNK) {
+        ck = (struct lchunk *)alloc(sizeof(struct lchunk));
+        ck->prev = 0;
+        if ((ck->next = arenas[lev]))
+          ck->next->prev = ck;
+        ck->live = 0;
+        ck->lev = lev;
+        ck->used = 0;
+        arenas[lev] = ck;
+        if (++arena_chunks > arena_peakchunks)
+          arena_peakchunks = arena_chunks;
+      }
+      start = (char *)ck->data + ck->used;
+      ck->used += need;
+      arena_bumped++;
+    }
+    ck->live++;
+    if (++arena_blocks > arena_peakblocks)
+      arena_peakblocks = arena_blocks;
+  }
+  if (pre) /* no id, no chain */
+    (void)memset(start, 0, pre);
+  h = (union lhdr *)(start + pre);
+  h->b.ck = ck;
+  h->b.units = (unsigned short)units;
+  h->b.pre = (unsigned short)pre;
+#ifdef ALLOC_STATS
+  if (ck) {
+    h->b.site = asite_of(site);
+    acount(h->b.site, (long)(need - LHDRSZ - pre));
+  }
+#endif
+  return (h + 1);
+}
+
+#ifdef ALLOC_STATS
+void *lalloc_at(unsigned lth, const char *site) {
+  return (lget(0, lth, site));
+}
+
+/* MODERN: an object or monster (ided), or gold or a trap; see struct lchain */
+void *lalloc_chained_at(unsigned lth, boolean ided, const char *site) {
+  return (lget(ided ? LIDENT : LLINKS, lth, site));
+}
+#else
+void *lalloc(unsigned lth) { return (lget(0, lth)); }
+
+/* MODERN: an object or monster (ided), or gold or a trap; see struct lchain */
+void *lalloc_chained(unsigned lth, boolean ided) {
+  return (lget(ided ? LIDENT : LLINKS, lth));
+}
+#endif
+
+void lfree(void *ptr) {
+  union lhdr *h = (union lhdr *)ptr - 1;
+  struct lchunk *ck = h->b.ck;
+  unsigned units = h->b.units;
+
+  if (h->b.pre == LIDENT && LCHAIN(h)->id) /* MODERN: see hack.ident.c */
+    id_forget(LCHAIN(h)->id, ptr);
+  if (!ck) {
+#ifdef ALLOC_STATS
+    afree((char *)h - h->b.pre);
+#else
+    free((char *)h - h->b.pre);
+#endif
+    return;
+  }
+#ifdef ALLOC_STATS
+  adrop(h->b.site, (long)(units * LHDRSZ - LHDRSZ - h->b.pre));
+#endif
+  arena_blocks--;
+  ck->live--;
+  if (units <= LPOOL) { /* keep it for the next one, headed at its start */
+    h = (union lhdr *)((char *)h - h->b.pre);
+    h->b.ck = ck;
+    h->b.units = (unsigned short)units;
+    h[1].p = pools[ck->lev][units];
+    pools[ck->lev][units] = h;
+  }
+}
+
+/* MODERN: the id the id index filed a block under; see hack.ident.c */
+unsigned lgetid(void *ptr) { return (LCHAIN((union lhdr *)ptr - 1)->id); }
+
+void lsetid(void *ptr, unsigned id) { LCHAIN((union lhdr *)ptr - 1)->id = id; }
+
+/* MODERN: the order number of an object in fobj; see hack.grid.c */
+unsigned lgetseq(void *ptr) { return (LCHAIN((union lhdr *)ptr - 1)->seq); }
+
+void lsetseq(void *ptr, unsigned seq) {
+  LCHAIN((union lhdr *)ptr - 1)->seq = seq;
+}
+
+/* level lev is stored: free its chunks, hand on those still in use */
+void arena_release(int lev) {
+  struct lchunk *ck, *ck2;
+  union lhdr *h, *h2;
+  int u;
+
+  if (lev < 0 || lev > MAXLEVEL)
+    return;
+  for (u = 1; u <= LPOOL; u++) /* the dead blocks of chunks handed on */
+    for (h = pools[lev][u]; h; h = h2) {
+      h2 = (union lhdr *)h[1].p;
+      if (h->b.ck->live) {
+        h[1].p = pools[LSPARE][u];
+        pools[LSPARE][u] = h;
+      }
+    }
+  (void)memset((char *)pools[lev], 0, sizeof(pools[lev]));
+  for (ck = arenas[lev]; ck; ck = ck2) {
+    ck2 = ck->next;
+    if (ck->live) {
+      ck->lev = LSPARE;
+      ck->prev = 0;
+      if ((ck->next = arenas[LSPARE]))
+        ck->next->prev = ck;
+      arenas[LSPARE] = ck;
+      continue;
+    }
+    arena_chunks--;
+    free((char *)ck);
+  }
+  arenas[lev] = 0;
+  arena_handed = 0;
+  for (ck = arenas[LSPARE]; ck; ck = ck->next)
+    arena_handed++;
+  if (arena_handed > arena_peakhanded)
+    arena_peakhanded = arena_handed;
+}
+
+void prarenastats(void) {
+  pline("Level arenas: %ld chunks (%ld KB), %ld blocks; %ld handed on "
+        "with carried things (peak %ld).",
+        arena_chunks, arena_chunks * (long)(sizeof(struct lchunk) / 1024),
+        arena_blocks, arena_handed, arena_peakhanded);
+  pline("Arena pools: %ld of %ld blocks reused; peak %ld chunks, "
+        "%ld blocks.",
+        arena_reused, arena_reused + arena_bumped, arena_peakchunks,
+        arena_peakblocks);
+}
+
 #endif /* LINT */
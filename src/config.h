@@ -138,4 +138,27 @@ typedef xchar boolean; /* 0 or 1 */
 
 #define SIZE(x) (int)(sizeof(x) / sizeof(x[0]))
 
+/*
+ * MODERN ADDITION (2026): Allocation accounting (cmake -DENABLE_ALLOC_STATS=ON)
+ * Every alloc(), lalloc() and enlarge() names its call site, and free()
+ * settles the block against it; see alloc.c. Without ALLOC_STATS these
+ * are the plain functions and cost nothing extra.
+ */
+#ifdef ALLOC_STATS
+extern void *alloc_at(unsigned lth, const char *site);
+extern void *lalloc_at(unsigned lth, const char *site);
+extern void *lalloc_chained_at(unsigned lth, boolean ided, const char *site);
+extern void *enlarge_at(char *ptr, unsigned lth, const char *site);
+extern void afree(void *ptr);
+extern void check_allocstats(void);
+#define ALLOC_LINE(l) #l
+#define ALLOC_SITE(l) __FILE__ ":" ALLOC_LINE(l)
+#define alloc(lth) alloc_at((lth), ALLOC_SITE(__LINE__))
+#define lalloc(lth) lalloc_at((lth), ALLOC_SITE(__LINE__))
+#define lalloc_chained(lth, ided)                                              \
+  lalloc_chained_at((lth), (ided), ALLOC_SITE(__LINE__))
+#define enlarge(ptr, lth) enlarge_at((ptr), (lth), ALLOC_SITE(__LINE__))
+#define free(ptr) afree(ptr)
+#endif /* ALLOC_STATS */
+
 #endif /* CONFIG */
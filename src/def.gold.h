@@ -10,4 +10,4 @@ struct gold {
 extern struct gold *fgold;
 struct gold *g_at(int x,
                   int y); /* K&R function with proper parameter declaration */
-#define newgold() (struct gold *)alloc(sizeof(struct gold))
+#define newgold() (struct gold *)lalloc_chained(sizeof(struct gold), 0)
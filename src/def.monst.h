@@ -46,7 +46,7 @@ struct monst {
 };
 
 #define newmonst(xl)                                                           \
-  (struct monst *)alloc((unsigned)(xl) + sizeof(struct monst))
+  (struct monst *)lalloc_chained((unsigned)(xl) + sizeof(struct monst), 1)
 
 extern struct monst *fmon;
 extern struct monst *fallen_down;
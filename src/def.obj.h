@@ -43,6 +43,7 @@ struct obj {
 
 extern struct obj *fobj;
 
-#define newobj(xl) (struct obj *)alloc((unsigned)(xl) + sizeof(struct obj))
+#define newobj(xl)                                                             \
+  (struct obj *)lalloc_chained((unsigned)(xl) + sizeof(struct obj), 1)
 #define ONAME(otmp) ((char *)otmp->oextra)
 #define OGOLD(otmp) (otmp->oextra[0])
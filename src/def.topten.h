@@ -0,0 +1,47 @@
+/* Copyright (c) Stichting Mathematisch Centrum, Amsterdam, 1985. */
+/* def.topten.h - version 1.0.3 */
+
+/**
+ * MODERN: Expanded buffer sizes for modern systems */
+#define NAMSZ 64 /* MODERN: Expanded from 8 to handle modern usernames */
+#define DTHSZ                                                                  \
+  128 /* MODERN: Expanded from 40 to prevent death message truncation */
+#define PERSMAX 1
+#define POINTSMIN 1  /* must be > 0 */
+#define ENTRYMAX 100 /* must be >= 10 */
+#define PERS_IS_UID  /* delete for PERSMAX per name; now per uid */
+struct toptenentry {
+  struct toptenentry *tt_next;
+  long int points;
+  int level, maxlvl, hp, maxhp;
+  int uid;
+  char plchar;
+  char sex;
+  char name[NAMSZ + 1];
+  char death[DTHSZ + 1];
+  char date[7]; /* yymmdd */
+  int recno;    /* MODERN: offset in the record store, -1 until published */
+};
+
+extern struct toptenentry *tt_head;
+struct toptenentry *newttentry(void);
+void reset_topten_arena(void);
+
+int ttmerge(struct toptenentry **ents, int n, struct toptenentry *t0,
+            struct toptenentry **list, int *rank0, int *rank1, int *flg);
+
+/* MODERN ADDITION (2026): record store, see hack.record.c */
+#define REC_NOREAD (-1)  /* the list cannot be read */
+#define REC_NOLOCK (-2)  /* the record lock cannot be had */
+#define REC_NOWRITE (-3) /* the new list cannot be written */
+int rec_load(struct toptenentry **ents);
+int rec_score(struct toptenentry *t0, struct toptenentry **list, int *rank0,
+              int *rank1, boolean hold);
+
+struct recstats {
+  long publishes, retries;  /* lists written, rankings redone */
+  long locks, lockfails;    /* record lock taken, given up on */
+  long waitus, maxwaitus;   /* microseconds waiting for the lock */
+  long holdus, maxholdus;   /* microseconds holding it */
+};
+extern struct recstats recstats;
@@ -11,7 +11,7 @@ struct trap {
 
 extern struct trap *ftrap;
 struct trap *t_at(int x, int y);
-#define newtrap() (struct trap *)alloc(sizeof(struct trap))
+#define newtrap() (struct trap *)lalloc_chained(sizeof(struct trap), 0)
 
 /* various kinds of traps */
 #define BEAR_TRAP 0
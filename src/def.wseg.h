@@ -9,5 +9,5 @@ struct wseg {
   unsigned wdispl : 1;
 };
 
-#define newseg() (struct wseg *)alloc(sizeof(struct wseg))
+#define newseg() (struct wseg *)lalloc(sizeof(struct wseg))
 #endif /* NOWORM */
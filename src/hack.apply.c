@@ -144,8 +144,7 @@ static int in_ice_box(struct obj *obj) {
   current_ice_box->owt += obj->owt;
   freeinv(obj);
   obj->o_cnt_id = current_ice_box->o_id;
-  obj->nobj = fcobj;
-  fcobj = obj;
+  obj_link(&fcobj, obj);
   obj->age = moves - obj->age; /* actual age */
   return (1);
 }
@@ -155,15 +154,8 @@ static int ck_ice_box(struct obj *obj) {
 }
 
 static int out_ice_box(struct obj *obj) {
-  struct obj *otmp;
-  if (obj == fcobj)
-    fcobj = fcobj->nobj;
-  else {
-    for (otmp = fcobj; otmp->nobj != obj; otmp = otmp->nobj)
-      if (!otmp->nobj)
-        panic("out_ice_box");
-    otmp->nobj = obj->nobj;
-  }
+  if (!obj_unlink(&fcobj, obj))
+    panic("out_ice_box");
   current_ice_box->owt -= obj->owt;
   obj->age = moves - obj->age; /* simulated point of time */
   (void)addinv(obj);
@@ -175,8 +167,10 @@ static void use_ice_box(struct obj *obj) {
   struct obj *otmp;
   current_ice_box = obj; /* for use by in/out_ice_box */
   for (otmp = fcobj; otmp; otmp = otmp->nobj)
-    if (otmp->o_cnt_id == obj->o_id)
+    if (otmp->o_cnt_id == obj->o_id) {
       cnt++;
+      break; /* MODERN: only whether it is empty matters */
+    }
   if (!cnt)
     pline("Your ice-box is empty.");
   else {
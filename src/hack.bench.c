@@ -0,0 +1,934 @@
+/* hack.bench.c - Microbenchmark driver for core engine paths
+ *
+ * MODERN ADDITION (2026): Built as hack-bench from the game sources with
+ * HACK_BENCH defined, which leaves out main() in hack.main.c. Each benchmark
+ * sets up the game state it needs directly, without a terminal session,
+ * and prints one line per measurement.
+ *
+ * Usage: hack-bench [benchmark] [seed]
+ *
+ * movemon    monster turns on a crowded open level, 1984 rescan of fmon
+ *            against the per-turn run queue; also checks that both leave
+ *            the level in the same state
+ * levfile    savelev()/getlev() round trip of a generated level through a
+ *            level file, field by field and through the buffered streams,
+ *            as the 1984 in-memory structs and as a level image
+ * stairs     goto_level() up and down ten generated levels (in a scratch
+ *            directory), counting level file reads and writes and alloc()
+ *            calls per change, without and with the resident level cache
+ * restore    dosave0() and dorecover() of a game 1, 5 and 25 levels deep
+ * record     eight processes ending games against one record store at
+ *            once, with the record lock held over the whole update and
+ *            only over the publish; reports lock wait and hold times and
+ *            checks the final list
+ * ops        ns, alloc() calls and output bytes per operation for mklev(),
+ *            a savelev()/getlev() round trip, dosave0()/dorecover(),
+ *            movemon(), docrt(), a step redrawn by nscr(), pline(),
+ *            doname(), a monster killed and its loot picked up and thrown
+ *            away (the arena must not grow), level changes carrying
+ *            things and a dog between ten levels (the arenas must not
+ *            grow either), freeobj() on the oldest of a
+ *            2000-object pile and each of its objects found by o_id, the
+ *            dice (rn2() beside libc random() % x, d()) and hack_timeout()
+ *            with no timeout running and with three; one line each, for
+ *            comparing builds
+ *
+ * Game output goes to a scratch file through the game's own stdout buffer,
+ * so output bytes are counted as the terminal would receive them.
+ */
+
+#include "hack.h"
+#include "def.topten.h"
+#include <stdio.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+extern char fut_geno[];
+extern struct monst *fdmon;
+extern int monq_legacy;
+extern long monq_steps_total(void);
+extern long levio_calls(void);
+extern void levcache_drop(void);
+extern boolean level_exists[];
+extern char lock[];
+extern void glo(int foo);
+extern void goto_level(int newlevel, boolean at_stairs);
+extern void init_objects(void);
+extern void startup(void);
+extern int dosave0(int hu);
+extern char SAVEF[];
+extern char obuf[];
+extern long alloc_calls;
+extern long arena_chunks, arena_handed;
+extern void dmonsfree(void);
+
+static unsigned bench_seed = 1984;
+static FILE *bench_out;
+
+static double now_ns(void) {
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((double)ts.tv_sec * 1e9 + (double)ts.tv_nsec);
+}
+
+/* forget whatever the previous run left on the level */
+static void bench_clear_level(void) {
+  int fd, x, y;
+
+  /* savelev() frees every chain of the level it writes out */
+  if ((fd = open("/dev/null", O_WRONLY)) >= 0) {
+    savelev(fd, dlevel);
+    (void)close(fd);
+  }
+  for (x = 0; x < COLNO; x++)
+    for (y = 0; y < ROWNO; y++) {
+      levl[x][y] = (struct rm){0};
+      if (x == 0 || x == COLNO - 1 || y == 0 || y == ROWNO - 1)
+        levl[x][y].typ = HWALL;
+      else
+        levl[x][y].typ = ROOM;
+    }
+  rooms[0].hx = -1; /* no rooms: inroom() stops at once */
+}
+
+/*
+ * An open level with nmon peaceful monsters, the player boxed in at the
+ * top left corner so nothing is fought; the same seed gives the same level.
+ * Asleep, most monsters do little more than be picked for their move.
+ */
+static void bench_crowd(int nmon, int asleep) {
+  struct monst *mtmp;
+  int x, y;
+
+  rnd_seed(bench_seed);
+  flags.ident = 1;
+  bench_clear_level();
+  levl[2][1].typ = levl[2][2].typ = levl[1][2].typ = HWALL;
+  u.ux = 1;
+  u.uy = 1;
+  while (nmon) {
+    x = rn1(COLNO - 4, 3);
+    y = rn1(ROWNO - 4, 3);
+    if (m_at(x, y))
+      continue;
+    if (!(mtmp = makemon((struct permonst *)0, x, y)))
+      continue;
+    mtmp->mpeaceful = 1;
+    mtmp->msleep = asleep;
+    nmon--;
+  }
+  moves = 1;
+}
+
+/* what is where on the level */
+static unsigned long bench_level_only(void) {
+  struct monst *mtmp;
+  struct obj *otmp;
+  struct gold *gold;
+  struct trap *trap;
+  unsigned long h = 5381;
+  int x, y;
+
+  for (x = 0; x < COLNO; x++)
+    for (y = 0; y < ROWNO; y++)
+      h = h * 33 + (unsigned long)levl[x][y].typ;
+  for (mtmp = fmon; mtmp; mtmp = mtmp->nmon)
+    h = h * 33 + (unsigned long)(mtmp->m_id * 131 + mtmp->mx * 37 + mtmp->my);
+  for (otmp = fobj; otmp; otmp = otmp->nobj)
+    h = h * 33 + (unsigned long)(otmp->o_id * 131 + otmp->ox * 37 + otmp->oy);
+  for (gold = fgold; gold; gold = gold->ngold)
+    h = h * 33 + (unsigned long)(gold->amount + gold->gx * 37 + gold->gy);
+  for (trap = ftrap; trap; trap = trap->ntrap)
+    h = h * 33 + (unsigned long)(trap->ttyp * 131 + trap->tx * 37 + trap->ty);
+  return (h);
+}
+
+/* what is where on the level, and where the RNG is */
+static unsigned long bench_level_hash(void) {
+  return (bench_level_only() * 33 + rnd_state());
+}
+
+static void bench_movemon(void) {
+  static const int crowds[] = {50, 200, 400, 800};
+  int i, asleep, legacy, turn, turns = 200;
+  unsigned long hash[2];
+  double t, ns[2];
+  long steps[2];
+
+  for (asleep = 0; asleep <= 1; asleep++)
+  for (i = 0; i < SIZE(crowds); i++) {
+    for (legacy = 1; legacy >= 0; legacy--) {
+      bench_crowd(crowds[i], asleep);
+      monq_legacy = legacy;
+      steps[legacy] = -monq_steps_total();
+      t = now_ns();
+      for (turn = 0; turn < turns; turn++) {
+        flags.toplin = 0;
+        movemon();
+        moves++;
+      }
+      ns[legacy] = (now_ns() - t) / turns;
+      steps[legacy] += monq_steps_total();
+      hash[legacy] = bench_level_hash();
+    }
+    fprintf(bench_out,
+            "movemon %4d %s: rescan %9.0f ns/turn %7ld steps/turn, "
+            "queue %9.0f ns/turn %5ld steps/turn, %s\n",
+            crowds[i], asleep ? "asleep" : "awake ", ns[1], steps[1] / turns, ns[0], steps[0] / turns,
+            hash[0] == hash[1] ? "same level" : "LEVELS DIFFER");
+    if (hash[0] != hash[1])
+      exit(1);
+  }
+  monq_legacy = 0;
+}
+
+static void bench_levfile(void) {
+  static const char tmpl[] = "/tmp/hack-bench.XXXXXX";
+  char name[sizeof(tmpl)];
+  unsigned long hash[4];
+  int legacy, buffered, fd, i, rounds = 200;
+  off_t size = 0;
+  double t, ns;
+  long calls;
+  struct stat st;
+
+  for (legacy = 1; legacy >= 0; legacy--)
+  for (buffered = 0; buffered <= 1; buffered++) {
+    levimg_legacy = legacy;
+    rnd_seed(bench_seed);
+    flags.ident = 1;
+    bench_clear_level();
+    mklev();
+    (void)strcpy(name, tmpl);
+    if ((fd = mkstemp(name)) < 0)
+      return;
+    (void)close(fd);
+    calls = -levio_calls();
+    t = now_ns();
+    for (i = 0; i < rounds; i++) {
+      if ((fd = open(name, O_WRONLY | O_TRUNC)) < 0)
+        break;
+      if (buffered)
+        bufon(fd);
+      savelev(fd, dlevel);
+      if (buffered && bufoff(fd) < 0)
+        break;
+      (void)close(fd);
+      if ((fd = open(name, O_RDONLY)) < 0)
+        break;
+      if (buffered)
+        mbufon(fd);
+      getlev(fd, 0, dlevel);
+      if (buffered)
+        mbufoff(fd);
+      (void)close(fd);
+    }
+    ns = (now_ns() - t) / rounds;
+    calls += levio_calls();
+    /* every way must bring back the same level */
+    hash[2 * legacy + buffered] = bench_level_hash();
+    if (stat(name, &st) == 0)
+      size = st.st_size;
+    (void)unlink(name);
+    fprintf(bench_out,
+            "levfile %s %s: %9.0f ns/round trip %6ld syscalls/round trip, "
+            "%ld bytes\n",
+            legacy ? "structs" : "image  ", buffered ? "buffered  " : "unbuffered",
+            ns, calls / rounds, (long)size);
+  }
+  levimg_legacy = 0;
+  if (hash[0] != hash[1] || hash[0] != hash[2] || hash[0] != hash[3]) {
+    fprintf(bench_out, "levfile: LEVELS DIFFER\n");
+    exit(1);
+  }
+}
+
+static char bench_dir[24], bench_cwd[1024];
+
+/* levels 1 to deepest in a scratch directory, the player on the deepest */
+static int bench_dungeon(int deepest) {
+  int lev;
+
+  (void)strcpy(bench_dir, "/tmp/hack-bench.XXXXXX");
+  if (!getcwd(bench_cwd, sizeof(bench_cwd)) || !mkdtemp(bench_dir) ||
+      chdir(bench_dir) < 0)
+    return (0);
+  (void)strcpy(lock, "benchlock");
+  rnd_seed(bench_seed);
+  flags.ident = 1;
+  bench_clear_level();
+  (void)memset(level_exists, 0, (MAXLEVEL + 1) * sizeof(boolean));
+  dlevel = maxdlevel = 1;
+  mklev();
+  u.ux = xupstair;
+  u.uy = yupstair;
+  for (lev = 2; lev <= deepest; lev++) {
+    u.uhp = u.uhpmax;
+    goto_level(lev, TRUE);
+  }
+  return (1);
+}
+
+/* leave and remove the scratch directory; forget the levels kept in memory */
+static void bench_dungeon_done(int deepest) {
+  int lev;
+
+  for (lev = 0; lev <= deepest; lev++) {
+    glo(lev);
+    (void)unlink(lock);
+  }
+  (void)unlink(SAVEF);
+  if (chdir(bench_cwd) == 0)
+    (void)rmdir(bench_dir);
+  bench_clear_level();
+  levcache_drop();
+}
+
+static unsigned long bench_stairs(int cachekb) {
+  int lev, trip, trips = 20, deepest = 10, changes = 0;
+  unsigned long hash;
+  double t;
+  long calls, allocs;
+
+  levcache_kb = cachekb;
+  if (!bench_dungeon(deepest))
+    return (0);
+  calls = -levio_calls();
+  allocs = -alloc_calls;
+  t = now_ns();
+  for (trip = 0; trip < trips; trip++) {
+    for (lev = deepest - 1; lev >= 1; lev--, changes++) {
+      u.uhp = u.uhpmax;
+      flags.toplin = 0;
+      goto_level(lev, TRUE);
+    }
+    for (lev = 2; lev <= deepest; lev++, changes++) {
+      u.uhp = u.uhpmax;
+      flags.toplin = 0;
+      goto_level(lev, TRUE);
+    }
+  }
+  t = (now_ns() - t) / changes;
+  calls += levio_calls();
+  allocs += alloc_calls;
+  hash = bench_level_hash();
+  fprintf(bench_out,
+          "stairs levelcache:%-4d %9.0f ns/level change %5ld read+write "
+          "calls, %5ld alloc() calls/level change\n",
+          cachekb, t, calls / changes, allocs / changes);
+  bench_dungeon_done(deepest);
+  return (hash);
+}
+
+static void bench_restore(void) {
+  static const int depths[] = {1, 5, 25};
+  double save, rest;
+  int i, fd, ok;
+
+  for (i = 0; i < SIZE(depths); i++) {
+    if (!bench_dungeon(depths[i]))
+      return;
+    (void)strcpy(SAVEF, "benchsave");
+    save = now_ns();
+    ok = dosave0(1);
+    save = now_ns() - save;
+    rest = now_ns();
+    ok = ok && (fd = open(SAVEF, O_RDONLY)) >= 0 && dorecover(fd);
+    rest = now_ns() - rest;
+    fprintf(bench_out, "restore %2d levels: save %9.0f ns, restore %9.0f ns%s\n",
+            depths[i], save, rest, ok ? "" : " FAILED");
+    bench_dungeon_done(depths[i]);
+    if (!ok)
+      exit(1);
+  }
+}
+
+/* one finisher: 'games' random endings, its recstats sent down 'out' */
+static void bench_finisher(int id, int games, boolean hold, int out) {
+  static struct toptenentry t0;
+  struct toptenentry *list[ENTRYMAX];
+  int i, rank0, rank1;
+
+  srandom(bench_seed + id);
+  (void)memset(&recstats, 0, sizeof(recstats));
+  for (i = 0; i < games; i++) {
+    (void)memset(&t0, 0, sizeof(t0));
+    t0.uid = random() % 20;
+    t0.plchar = "CFKSTW"[random() % 6];
+    t0.sex = 'M';
+    t0.points = 1 + random() % 10000;
+    t0.level = t0.maxlvl = 1 + random() % 30;
+    (void)strcpy(t0.name, "bench");
+    (void)strcpy(t0.death, "quit");
+    (void)strcpy(t0.date, "261016");
+    (void)rec_score(&t0, list, &rank0, &rank1, hold);
+  }
+  if (write(out, &recstats, sizeof(recstats)) != (ssize_t)sizeof(recstats))
+    _exit(1);
+  _exit(0);
+}
+
+static void bench_record_run(boolean hold) {
+  int procs = 8, games = 100, fds[2], i, n, fd;
+  struct toptenentry *ents[ENTRYMAX];
+  struct recstats all, one;
+  char name[32];
+  double t;
+
+  (void)strcpy(bench_dir, "/tmp/hack-bench.XXXXXX");
+  if (!getcwd(bench_cwd, sizeof(bench_cwd)) || !mkdtemp(bench_dir) ||
+      chdir(bench_dir) < 0 || pipe(fds) < 0)
+    return;
+  if ((fd = creat(RECORD, FMASK)) >= 0)
+    (void)close(fd);
+  (void)fflush(bench_out);
+  t = now_ns();
+  for (i = 0; i < procs; i++)
+    if (fork() == 0)
+      bench_finisher(i, games, hold, fds[1]);
+  (void)close(fds[1]);
+  (void)memset(&all, 0, sizeof(all));
+  while (read(fds[0], &one, sizeof(one)) == (ssize_t)sizeof(one)) {
+    all.publishes += one.publishes;
+    all.retries += one.retries;
+    all.locks += one.locks;
+    all.lockfails += one.lockfails;
+    all.waitus += one.waitus;
+    all.holdus += one.holdus;
+    if (one.maxwaitus > all.maxwaitus)
+      all.maxwaitus = one.maxwaitus;
+    if (one.maxholdus > all.maxholdus)
+      all.maxholdus = one.maxholdus;
+  }
+  (void)close(fds[0]);
+  while (wait((int *)0) > 0)
+    ;
+  t = (now_ns() - t) / (procs * games);
+  if (!all.locks)
+    all.locks = 1;
+  fprintf(bench_out,
+          "record %-8s %d games: %7.0f ns/game, lock wait %6ld us avg %7ld "
+          "max, held %5ld us avg %6ld max, %ld retries, %ld lock failures\n",
+          hold ? "locked" : "snapshot", procs * games, t,
+          all.waitus / all.locks, all.maxwaitus, all.holdus / all.locks,
+          all.maxholdus, all.retries, all.lockfails);
+
+  /* the list must be ranked, one entry per player and class */
+  reset_topten_arena();
+  n = rec_load(ents);
+  for (i = 1; i < n; i++) {
+    int j;
+
+    if (ents[i]->points > ents[i - 1]->points)
+      break;
+    for (j = 0; j < i; j++)
+      if (ents[j]->uid == ents[i]->uid && ents[j]->plchar == ents[i]->plchar)
+        break;
+    if (j < i)
+      break;
+  }
+  if (n != ENTRYMAX || i < n) {
+    fprintf(bench_out, "record: BAD LIST (%d entries)\n", n);
+    exit(1);
+  }
+  (void)unlink(RECORD);
+  (void)unlink("record.idx");
+  (void)unlink("record.lock");
+  for (i = 0; i < 100; i++) {
+    snprintf(name, sizeof(name), "record.d%d", i);
+    (void)unlink(name);
+  }
+  if (chdir(bench_cwd) == 0)
+    (void)rmdir(bench_dir);
+}
+
+/* time, alloc() calls and output bytes of the measured stretches */
+struct meter {
+  double ns, t0;
+  long allocs, a0;
+  long bytes, b0;
+  long ops;
+};
+
+static void meter_on(struct meter *m) {
+  m->a0 = alloc_calls;
+  m->b0 = ftell(stdout);
+  m->t0 = now_ns();
+}
+
+static void meter_off(struct meter *m, long ops) {
+  m->ns += now_ns() - m->t0;
+  m->allocs += alloc_calls - m->a0;
+  m->bytes += ftell(stdout) - m->b0;
+  m->ops += ops;
+}
+
+static void meter_print(const char *what, struct meter *m) {
+  double n = m->ops ? (double)m->ops : 1.0;
+
+  fprintf(bench_out,
+          "ops %-17s %11.0f ns/op %9.1f allocs/op %8.0f bytes/op  (%ld ops)\n",
+          what, m->ns / n, (double)m->allocs / n, (double)m->bytes / n,
+          m->ops);
+}
+
+/* a generated level with the player on the up stairs */
+static void bench_mklev(void) {
+  rnd_seed(bench_seed);
+  flags.ident = 1;
+  bench_clear_level();
+  mklev();
+  u.ux = xupstair;
+  u.uy = yupstair;
+}
+
+static void ops_levels(void) {
+  static const char tmpl[] = "/tmp/hack-bench.XXXXXX";
+  char name[sizeof(tmpl)];
+  struct meter gen = {0}, file = {0}, save = {0};
+  int i, fd, ok = 1;
+  unsigned long h;
+
+  rnd_seed(bench_seed);
+  for (i = 0; i < 200; i++) {
+    dlevel = 1 + i % 20; /* the same depth gives the same level */
+    bench_clear_level();
+    meter_on(&gen);
+    mklev();
+    meter_off(&gen, 1);
+  }
+  meter_print("mklev", &gen);
+
+  /* level 7 again after other rolls and another level came first */
+  flags.ident = 1;
+  dlevel = 7;
+  bench_clear_level();
+  mklev();
+  h = bench_level_only();
+  for (i = 0; i < 1000; i++)
+    (void)rn2(6 + i);
+  dlevel = 3;
+  bench_clear_level();
+  mklev();
+  flags.ident = 1;
+  dlevel = 7;
+  bench_clear_level();
+  mklev();
+  if (bench_level_only() != h) {
+    fprintf(bench_out, "ops: LEVEL 7 DEPENDS ON WHAT CAME BEFORE\n");
+    exit(1);
+  }
+  dlevel = 10;
+
+  (void)strcpy(name, tmpl);
+  if ((fd = mkstemp(name)) < 0)
+    return;
+  (void)close(fd);
+  for (i = 0; i < 200 && ok; i++) {
+    meter_on(&file);
+    ok = (fd = open(name, O_WRONLY | O_TRUNC)) >= 0;
+    if (ok) {
+      bufon(fd);
+      savelev(fd, dlevel);
+      ok = bufoff(fd) >= 0;
+      (void)close(fd);
+    }
+    if (ok && (ok = (fd = open(name, O_RDONLY)) >= 0)) {
+      mbufon(fd);
+      getlev(fd, 0, dlevel);
+      mbufoff(fd);
+      (void)close(fd);
+    }
+    meter_off(&file, 1);
+  }
+  (void)unlink(name);
+  meter_print("savelev+getlev", &file);
+
+  if (!bench_dungeon(5))
+    return;
+  (void)strcpy(SAVEF, "benchsave");
+  for (i = 0; i < 20 && ok; i++) {
+    meter_on(&save);
+    ok = dosave0(1) && (fd = open(SAVEF, O_RDONLY)) >= 0 && dorecover(fd);
+    meter_off(&save, 1);
+  }
+  bench_dungeon_done(5);
+  meter_print("dosave0+dorecover", &save);
+  if (!ok) {
+    fprintf(bench_out, "ops: level files FAILED\n");
+    exit(1);
+  }
+}
+
+static void ops_movemon(void) {
+  struct meter m = {0};
+  int turn, turns = 200;
+
+  bench_crowd(200, 0);
+  meter_on(&m);
+  for (turn = 0; turn < turns; turn++) {
+    flags.toplin = 0;
+    movemon();
+    moves++;
+  }
+  meter_off(&m, turns);
+  meter_print("movemon 200", &m);
+}
+
+static void ops_screen(void) {
+  static const char *const what[] = {"jackal", "giant beetle", "gnome lord",
+                                     "homunculus", "owlbear"};
+  struct meter crt = {0}, step = {0}, msg = {0};
+  int i, x0, y0, x1 = 0, y1 = 0, dx, dy;
+
+  bench_mklev();
+  x0 = u.ux;
+  y0 = u.uy;
+  for (dx = -1; dx <= 1 && !x1; dx++)
+    for (dy = -1; dy <= 1; dy++)
+      if ((dx || dy) && levl[x0 + dx][y0 + dy].typ == ROOM) {
+        x1 = x0 + dx;
+        y1 = y0 + dy;
+        break;
+      }
+  start_screen();
+  cls();
+  setsee();
+  docrt();
+  flush_frame();
+
+  for (i = 0; i < 200; i++) {
+    meter_on(&crt);
+    docrt();
+    flush_frame();
+    meter_off(&crt, 1);
+  }
+  meter_print("docrt", &crt);
+
+  for (i = 0; i < 400 && x1; i++) {
+    u.ux = (i & 1) ? x0 : x1;
+    u.uy = (i & 1) ? y0 : y1;
+    meter_on(&step);
+    setsee();
+    nscr();
+    flush_frame();
+    meter_off(&step, 1);
+  }
+  meter_print("setsee+nscr", &step);
+
+  for (i = 0; i < 2000; i++) {
+    flags.toplin = 2; /* read by now: no --More-- */
+    meter_on(&msg);
+    pline("The %s hits!  [%d]", what[i % SIZE(what)], i);
+    flush_frame();
+    meter_off(&msg, 1);
+  }
+  meter_print("pline", &msg);
+  end_screen();
+  flags.toplin = 0;
+}
+
+static void ops_doname(void) {
+  struct obj *objs[64];
+  struct meter m = {0};
+  int i, n = 20000;
+
+  rnd_seed(bench_seed);
+  for (i = 0; i < SIZE(objs); i++)
+    objs[i] = mkobj(0);
+  meter_on(&m);
+  for (i = 0; i < n; i++)
+    (void)doname(objs[i % SIZE(objs)]);
+  meter_off(&m, n);
+  for (i = 0; i < SIZE(objs); i++)
+    lfree((char *)objs[i]);
+  meter_print("doname", &m);
+}
+
+/*
+ * The kill-loot-drop path: a monster made beside the player and killed,
+ * what it dropped picked up and thrown away, and two things left under
+ * the player for each two older ones taken away, so blocks die out of
+ * order. The level's arena must not grow once its pools are stocked.
+ */
+static void ops_loot(void) {
+  struct obj *keep[64], *otmp;
+  struct meter m = {0};
+  int i, n = 20000, x, y;
+  long chunks = 0;
+
+  bench_mklev();
+  (void)memset((char *)keep, 0, sizeof(keep));
+  x = u.ux;
+  y = u.uy;
+  x += levl[x + 1][y].typ == ROOM ? 1 : -1;
+  meter_on(&m);
+  for (i = 0; i < n; i++) {
+    if (i == n / 10)
+      chunks = arena_chunks;
+    (void)makemon((struct permonst *)0, x, y);
+    while (fmon) /* the ones that came along in a group too */
+      mondead(fmon);
+    dmonsfree();
+    while ((otmp = o_at(x, y))) {
+      freeobj(otmp);
+      obfree(otmp, (struct obj *)0);
+    }
+    otmp = keep[(i * 7) % SIZE(keep)]; /* not the oldest: mix them up */
+    if (otmp) {
+      freeobj(otmp);
+      obfree(otmp, (struct obj *)0);
+    }
+    keep[(i * 7) % SIZE(keep)] = mkobj_at(0, u.ux, u.uy);
+  }
+  meter_off(&m, n);
+  meter_print("kill-loot-drop", &m);
+  if (arena_chunks > chunks) {
+    fprintf(bench_out, "ops kill-loot-drop: ARENA GREW %ld -> %ld chunks\n",
+            chunks, arena_chunks);
+    exit(1);
+  }
+  bench_clear_level();
+}
+
+/*
+ * Up and down ten levels, none of them kept in memory, with a dog along
+ * and something picked up on every level: the newest 24 are carried, the
+ * oldest put down wherever the player is. What is carried pins the chunks
+ * of levels long stored: no more of them may be handed on than there are
+ * things carried, and the arenas must not grow after the first half.
+ */
+static void ops_carry(void) {
+  struct obj *carried[24], *otmp;
+  struct meter m = {0};
+  int i, lev = 10, step = -1, n = 400, deepest = 10;
+  long chunks = 0, most = 0, handed = 0;
+
+  levcache_kb = 0;
+  if (!bench_dungeon(deepest))
+    return;
+  (void)memset((char *)carried, 0, sizeof(carried));
+  makedog();
+  meter_on(&m);
+  for (i = 0; i < n; i++) {
+    if (lev + step < 1 || lev + step > deepest)
+      step = -step;
+    lev += step;
+    u.uhp = u.uhpmax;
+    flags.toplin = 0;
+    goto_level(lev, TRUE);
+    if ((otmp = carried[i % SIZE(carried)]))
+      dropx(otmp);
+    otmp = mkobj_at(0, u.ux, u.uy);
+    freeobj(otmp);
+    /* one merged into a stack already carried is not counted */
+    carried[i % SIZE(carried)] = (addinv(otmp) == otmp) ? otmp : 0;
+    if (i < n / 2)
+      chunks = arena_chunks > chunks ? arena_chunks : chunks;
+    else if (arena_chunks > most)
+      most = arena_chunks;
+    if (arena_handed > handed)
+      handed = arena_handed;
+  }
+  meter_off(&m, n);
+  meter_print("carry 10 levels", &m);
+  for (i = 0; i < SIZE(carried); i++)
+    if ((otmp = carried[i]))
+      dropx(otmp);
+  bench_dungeon_done(deepest);
+  levcache_kb = LEVCACHE_KB;
+  if (most > chunks || handed > SIZE(carried) + 2) { /* the dog, its load */
+    fprintf(bench_out,
+            "ops carry: ARENAS GREW %ld -> %ld chunks, %ld handed on\n",
+            chunks, most, handed);
+    exit(1);
+  }
+}
+
+/*
+ * freeobj() on a big pile: each round takes the oldest object, the one
+ * deepest in fobj, and drops it back on top.
+ */
+static void ops_unlink(void) {
+  struct obj *objs[2000], *otmp;
+  struct meter m = {0};
+  int i, n = 200000;
+
+  bench_mklev();
+  for (i = 0; i < SIZE(objs); i++)
+    objs[i] = mksobj_at(ROCK, u.ux, u.uy);
+  meter_on(&m);
+  for (i = 0; i < n; i++) {
+    otmp = objs[i % SIZE(objs)];
+    freeobj(otmp);
+    obj_link(&fobj, otmp);
+    place_object(otmp, u.ux, u.uy);
+  }
+  meter_off(&m, n);
+  meter_print("freeobj 2000-pile", &m);
+  bench_clear_level();
+}
+
+/* a shop bill's o_id back to its object, for each object of a big pile */
+static void ops_ident(void) {
+  unsigned ids[2000];
+  struct meter m = {0};
+  int i, n = 200000, miss = 0;
+
+  bench_mklev();
+  for (i = 0; i < SIZE(ids); i++)
+    ids[i] = mksobj_at(ROCK, u.ux, u.uy)->o_id;
+  meter_on(&m);
+  for (i = 0; i < n; i++)
+    if (!obj_by_id(ids[i % SIZE(ids)]))
+      miss++;
+  meter_off(&m, n);
+  meter_print("o_id 2000-pile", &m);
+  if (miss) {
+    fprintf(bench_out, "ops o_id 2000-pile: %d NOT FOUND\n", miss);
+    exit(1);
+  }
+  bench_clear_level();
+}
+
+/* rn2() against the 1984 random() % x it replaced, and a d(3,6) roll */
+static void ops_rng(void) {
+  struct meter m = {0}, lib = {0}, dice = {0};
+  int i, n = 1000000, acc = 0;
+
+  rnd_seed(bench_seed);
+  meter_on(&m);
+  for (i = 0; i < n; i++)
+    acc += rn2(2 + (i & 63));
+  meter_off(&m, n);
+  meter_print("rn2", &m);
+  srandom(bench_seed);
+  meter_on(&lib);
+  for (i = 0; i < n; i++)
+    acc += (int)(random() % (2 + (i & 63)));
+  meter_off(&lib, n);
+  meter_print("random() % x", &lib);
+  meter_on(&dice);
+  for (i = 0; i < n; i++)
+    acc += d(3, 6);
+  meter_off(&dice, n);
+  meter_print("d(3,6)", &dice);
+  if (acc < 3 * n) /* d(3,6) alone is at least 3 */
+    fprintf(bench_out, "ops rng: RESULTS OUT OF RANGE\n");
+}
+
+/* hack_timeout() on turns with no timeout running and with three */
+static void ops_timeout(void) {
+  struct meter idle = {0}, busy = {0};
+  int i, n = 1000000;
+
+  meter_on(&idle);
+  for (i = 0; i < n; i++) {
+    hack_timeout();
+    moves++;
+  }
+  meter_off(&idle, n);
+  meter_print("timeout idle", &idle);
+  meter_on(&busy);
+  for (i = 0; i < n; i++) {
+    if (!(i % 4000)) { /* extended before they can run out */
+      set_utimeout(FAST, (long)TIMEOUT);
+      set_utimeout(CONFUSION, (long)TIMEOUT);
+      set_utimeout(PROP(RIN_SEARCHING), (long)TIMEOUT);
+    }
+    hack_timeout();
+    moves++;
+  }
+  meter_off(&busy, n);
+  meter_print("timeout 3 running", &busy);
+  set_utimeout(FAST, 0L);
+  set_utimeout(CONFUSION, 0L);
+  set_utimeout(PROP(RIN_SEARCHING), 0L);
+}
+
+/* every --More-- the game asks for is answered */
+static void bench_spaces(void) {
+  char name[] = "/tmp/hack-bench.XXXXXX", spaces[4096];
+  int fd, i;
+
+  if ((fd = mkstemp(name)) < 0)
+    return;
+  (void)unlink(name);
+  (void)memset(spaces, '\n', sizeof(spaces));
+  for (i = 0; i < 256; i++)
+    if (write(fd, spaces, sizeof(spaces)) != (ssize_t)sizeof(spaces))
+      break;
+  (void)lseek(fd, (off_t)0, SEEK_SET);
+  (void)dup2(fd, 0);
+  (void)close(fd);
+}
+
+int main(int argc, char *argv[]) {
+  const char *which = (argc > 1) ? argv[1] : "all";
+  char name[] = "/tmp/hack-bench.XXXXXX";
+  int fd;
+
+  if (argc > 2)
+    bench_seed = (unsigned)atoi(argv[2]);
+
+  /* game output goes to a scratch file; results go to the real stdout */
+  if (!(bench_out = fdopen(dup(1), "w")) || (fd = mkstemp(name)) < 0 ||
+      dup2(fd, 1) < 0)
+    return (1);
+  (void)unlink(name);
+  (void)close(fd);
+  (void)setvbuf(stdout, obuf, _IOFBF, FRAMEBUFSZ);
+  bench_spaces();
+  if (!getenv("TERM"))
+    (void)setenv("TERM", "vt100", 1);
+  startup();
+  (void)strcpy(fut_geno, "w"); /* no long worms: they own segment chains */
+  dlevel = 10;
+  u.ulevel = 10;
+  u.uhp = u.uhpmax = 100;
+  u.ustr = u.ustrmax = 18;
+  u.usym = '@';
+  flags.ident = 1;
+  init_objects();
+
+  if (!strcmp(which, "all") || !strcmp(which, "movemon"))
+    bench_movemon();
+  if (!strcmp(which, "all") || !strcmp(which, "levfile"))
+    bench_levfile();
+  if (!strcmp(which, "all") || !strcmp(which, "stairs")) {
+    /* with the cache or without, the trips must end in the same state */
+    unsigned long hash = bench_stairs(0);
+
+    if (bench_stairs(64) != hash || /* some levels spilled to files */
+        bench_stairs(LEVCACHE_KB) != hash) {
+      fprintf(bench_out, "stairs: LEVELS DIFFER\n");
+      exit(1);
+    }
+  }
+  if (!strcmp(which, "all") || !strcmp(which, "restore"))
+    bench_restore();
+  if (!strcmp(which, "all") || !strcmp(which, "record")) {
+    bench_record_run(TRUE);
+    bench_record_run(FALSE);
+  }
+  if (!strcmp(which, "all") || !strcmp(which, "ops")) {
+    ops_levels();
+    ops_movemon();
+    ops_screen();
+    ops_doname();
+    ops_loot();
+    ops_carry();
+    ops_unlink();
+    ops_ident();
+    ops_rng();
+    ops_timeout();
+  }
+  (void)fflush(bench_out);
+  return (0);
+}
@@ -22,13 +22,15 @@ char bones[] = "bones_xx";
 /* save bones and possessions of a deceased adventurer */
 void savebones(void) {
   int fd;
-  struct obj *otmp;
+  struct obj *otmp, *pred;
   struct trap *ttmp;
   struct monst *mtmp;
   if (dlevel <= 0 || dlevel > MAXLEVEL)
     return;
   if (!rn2(1 + dlevel / 2))
     return; /* not so many ghosts on low levels */
+  if (jr_mode != JR_OFF)
+    return; /* MODERN: journaled games keep to themselves */
   bones[6] = '0' + (dlevel / 10);
   bones[7] = '0' + (dlevel % 10);
   if ((fd = open(bones, 0)) >= 0) {
@@ -36,26 +38,24 @@ void savebones(void) {
     return;
   }
   /* drop everything; the corpse's possessions are usually cursed */
-  otmp = invent;
-  while (otmp) {
-    otmp->ox = u.ux;
-    otmp->oy = u.uy;
+  /* MODERN: moved one by one, in order, to the front of fobj - was spliced */
+  pred = 0;
+  while ((otmp = invent)) {
+    (void)obj_unlink(&invent, otmp);
     otmp->age = 0; /* very long ago */
     otmp->owornmask = 0;
     if (rn2(5))
       otmp->cursed = 1;
-    if (!otmp->nobj) {
-      otmp->nobj = fobj;
-      fobj = invent;
-      invent = 0; /* superfluous */
-      break;
-    }
-    otmp = otmp->nobj;
+    if (pred)
+      obj_after(pred, otmp);
+    else
+      obj_link(&fobj, otmp);
+    place_object(otmp, u.ux, u.uy);
+    pred = otmp;
   }
   if (!(mtmp = makemon(PM_GHOST, u.ux, u.uy)))
     return;
-  mtmp->mx = u.ux;
-  mtmp->my = u.uy;
+  place_monster(mtmp, u.ux, u.uy); /* MODERN: was mx = u.ux, my = u.uy */
   mtmp->msleep = 1;
   (void)strncpy((char *)mtmp->mextra, plname, PL_NSIZ - 1);
   ((char *)mtmp->mextra)[PL_NSIZ - 1] =
@@ -86,20 +86,38 @@ void savebones(void) {
   }
   if ((fd = creat(bones, FMASK)) < 0)
     return;
+  bufon(fd); /* MODERN: one write for the whole bones file */
   savelev(fd, dlevel);
+  if (bufoff(fd) < 0) {
+    (void)close(fd);
+    (void)unlink(bones); /* a partial bones file would end someone's game */
+    return;
+  }
   (void)close(fd);
 }
 
+/* MODERN: is there a bones file getbones() could find on lev? */
+boolean hasbones(int lev) {
+  bones[6] = '0' + lev / 10;
+  bones[7] = '0' + lev % 10;
+  return (boolean)(access(bones, F_OK) == 0);
+}
+
 int getbones(void) {
   int fd, x, y, ok;
   if (rn2(3))
     return (0); /* only once in three times do we find bones */
+  if (jr_mode != JR_OFF)
+    return (0); /* MODERN: a replay could not find the same ones */
   bones[6] = '0' + dlevel / 10;
   bones[7] = '0' + dlevel % 10;
   if ((fd = open(bones, 0)) < 0)
     return (0);
-  if ((ok = uptodate(fd)) != 0) {
+  /* MODERN: a level image is good to any build, see hack.levimg.c */
+  if ((ok = (limg_file(fd) || uptodate(fd))) != 0) {
+    mbufon(fd);
     getlev(fd, 0, dlevel);
+    mbufoff(fd);
     for (x = 0; x < COLNO; x++)
       for (y = 0; y < ROWNO; y++)
         levl[x][y].seen = levl[x][y].new = 0;
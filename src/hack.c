@@ -222,8 +222,8 @@ void domove(void) {
         delobj(otmp);
         continue;
       }
-      otmp->ox = rx;
-      otmp->oy = ry;
+      remove_object(otmp); /* MODERN: was otmp->ox = rx; otmp->oy = ry; */
+      place_object(otmp, rx, ry);
       /* pobj(otmp); */
       if (cansee(rx, ry))
         atl(rx, ry, otmp->olet);
@@ -287,8 +287,8 @@ void domove(void) {
 
     movobj(uball, uchain->ox, uchain->oy);
     unpobj(uball); /* BAH %% */
-    uchain->ox = u.ux;
-    uchain->oy = u.uy;
+    remove_object(uchain); /* MODERN: was uchain->ox/oy = u.ux/u.uy */
+    place_object(uchain, u.ux, u.uy);
     nomul(-2);
     nomovemsg = "";
   nodrag:;
@@ -358,10 +358,8 @@ void movobj(struct obj *obj, int ox, int oy) {
   /* Some dirty programming to get display right */
   freeobj(obj);
   unpobj(obj);
-  obj->nobj = fobj;
-  fobj = obj;
-  obj->ox = ox;
-  obj->oy = oy;
+  obj_link(&fobj, obj);
+  place_object(obj, ox, oy); /* MODERN: was obj->ox = ox; obj->oy = oy; */
 }
 
 int dopickup(void) {
@@ -482,7 +480,8 @@ int pickup(int all) {
             goto too_heavy;
           pline("You can only carry %s of the %s lying here.",
                 (qq == 1) ? "one" : "some", doname(obj));
-          (void)splitobj(obj, qq);
+          /* MODERN: the remainder stays on the floor - index it */
+          place_object(splitobj(obj, qq), obj->ox, obj->oy);
           /* note: obj2 is set already, so we'll never
            * encounter the other half; if it should be
            * otherwise then write
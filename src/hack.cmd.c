@@ -20,6 +20,9 @@ int doredraw(), doredotopl(), dodrop(), dodrink(), doread(), dopickup(),
     doprwep(), doprarm(), doprring(), doprgold(), dodiscovered(), dotypeinv(),
     dolook(), doset(), doup(), dodown(), donull(), dothrow(), doextcmd(),
     dodip(), dopray();
+#ifdef WIZARD
+int dostats();
+#endif /* WIZARD */
 #ifdef SHELL
 int dosh();
 #endif /* SHELL */
@@ -92,7 +95,12 @@ struct func_tab cmdlist[] = {
 };
 
 struct ext_func_tab extcmdlist[] = {
-    {"dip", dodip}, {"pray", dopray}, {(char *)0, donull}};
+    {"dip", dodip},
+    {"pray", dopray},
+#ifdef WIZARD
+    {"stats", dostats}, /* MODERN: wizard-mode performance counters */
+#endif /* WIZARD */
+    {(char *)0, donull}};
 
 extern char *parse(), quitchars[];
 
@@ -218,6 +226,33 @@ int doextcmd(void) /* here after # - now read a full-word command */
   return (0);
 }
 
+#ifdef WIZARD
+/**
+ * MODERN ADDITION (2026): #stats wizard-mode extended command
+ *
+ * WHY: Server operators need to see what the engine costs per session
+ * (terminal output per frame and similar counters) without a profiler.
+ *
+ * HOW: Each subsystem keeps its own counters and prints them with pline().
+ *
+ * PRESERVES: Ordinary players never see the command.
+ * ADDS: A single place to read the performance counters during a game.
+ */
+int dostats(void) {
+  if (!wizard) {
+    pline("stats: unknown command.");
+    return (0);
+  }
+  prframestats();
+  prscrstats();
+  prmovestats();
+  prmonqstats();
+  prlevstats();
+  prarenastats();
+  return (0);
+}
+#endif /* WIZARD */
+
 char lowc(char sym) {
   return ((sym >= 'A' && sym <= 'Z') ? sym + 'a' - 'A' : sym);
 }
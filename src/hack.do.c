@@ -12,6 +12,7 @@
 
 #include "hack.h"
 /* MODERN ADDITION (2025): Added for POSIX file operations compatibility */
+#include <errno.h>
 #include <fcntl.h>  /* for open() function */
 #include <unistd.h> /* for close() function */
 
@@ -41,7 +42,7 @@ static int drop(struct obj *obj) {
       if (Invisible)
         newsym(u.ux, u.uy);
     }
-    free((char *)obj);
+    lfree((char *)obj);
     return (1);
   }
   if (obj->owornmask & (W_ARMOR | W_RING)) {
@@ -69,10 +70,8 @@ void dropx(struct obj *obj) {
 void dropy(struct obj *obj) {
   if (obj->otyp == CRYSKNIFE)
     obj->otyp = WORM_TOOTH;
-  obj->ox = u.ux;
-  obj->oy = u.uy;
-  obj->nobj = fobj;
-  fobj = obj;
+  obj_link(&fobj, obj);
+  place_object(obj, u.ux, u.uy); /* MODERN: was obj->ox/oy = u.ux/u.uy */
   if (Invisible)
     newsym(u.ux, u.uy);
   subfrombill(obj);
@@ -138,8 +137,8 @@ void goto_level(int newlevel, boolean at_stairs) {
     return; /* this can happen */
 
   glo(dlevel);
-  fd = creat(lock, FMASK);
-  if (fd < 0) {
+  fd = -1; /* MODERN: with the level cache on the level stays in memory */
+  if (levcache_kb <= 0 && (fd = creat(lock, FMASK)) < 0) {
     /*
      * This is not quite impossible: e.g., we may have
      * exceeded our quota. If that is the case then we
@@ -163,8 +162,16 @@ void goto_level(int newlevel, boolean at_stairs) {
   u.ux = FAR;     /* hack */
   (void)inshop(); /* probably was a trapdoor */
 
-  savelev(fd, dlevel);
-  (void)close(fd);
+  if (fd < 0) {
+    if (!cache_level(dlevel))
+      panic("Cannot keep level %d in memory", dlevel); /* impossible */
+  } else {
+    bufon(fd); /* MODERN: the level file goes out in one write */
+    savelev(fd, dlevel);
+    if (bufoff(fd) < 0)
+      panic("Cannot write level file %s: %s", lock, strerror(errno));
+    (void)close(fd);
+  }
 
   dlevel = newlevel;
   if (maxdlevel < dlevel)
@@ -172,9 +179,10 @@ void goto_level(int newlevel, boolean at_stairs) {
   glo(dlevel);
 
   /* Original 1984: if(!level_exists[dlevel]) */
-  if (dlevel >= 0 && dlevel <= MAXLEVEL && !level_exists[(int)dlevel]) /* MODERN: safe array indexing */
-    mklev();
-  else {
+  if (dlevel >= 0 && dlevel <= MAXLEVEL && !level_exists[(int)dlevel]) { /* MODERN: safe array indexing */
+    if (!pregen_take(dlevel)) /* MODERN: made while we waited? */
+      mklev();
+  } else if (!uncache_level(dlevel)) {
     extern int hackpid;
 
     if ((fd = open(lock, 0)) < 0) {
@@ -182,7 +190,9 @@ void goto_level(int newlevel, boolean at_stairs) {
       pline("Probably someone removed it.");
       done("tricked");
     }
+    mbufon(fd); /* MODERN: and comes back in one read */
     getlev(fd, hackpid, dlevel);
+    mbufoff(fd);
     (void)close(fd);
   }
 
@@ -426,10 +436,8 @@ int dothrow(void) {
   /* the code following might become part of dropy() */
   if (obj->otyp == CRYSKNIFE)
     obj->otyp = WORM_TOOTH;
-  obj->ox = bhitpos.x;
-  obj->oy = bhitpos.y;
-  obj->nobj = fobj;
-  fobj = obj;
+  obj_link(&fobj, obj);
+  place_object(obj, bhitpos.x, bhitpos.y); /* MODERN: was obj->ox/oy = ... */
   /* prevent him from throwing articles to the exit and escaping */
   /* subfrombill(obj); */
   stackobj(obj);
@@ -450,10 +458,11 @@ int dothrow(void) {
       u.utrap = 0;
     }
     unsee();
-    uchain->nobj = fobj;
-    fobj = uchain;
-    u.ux = uchain->ox = bhitpos.x - u.dx;
-    u.uy = uchain->oy = bhitpos.y - u.dy;
+    obj_link(&fobj, uchain);
+    /* MODERN: was u.ux = uchain->ox = bhitpos.x - u.dx; (and u.uy) */
+    place_object(uchain, bhitpos.x - u.dx, bhitpos.y - u.dy);
+    u.ux = uchain->ox;
+    u.uy = uchain->oy;
     setsee();
     (void)inshop();
   }
@@ -474,7 +483,7 @@ struct obj *splitobj(struct obj *obj, int num) {
   obj->owt = weight(obj);
   otmp->quan -= num;
   otmp->owt = weight(otmp); /* -= obj->owt ? */
-  obj->nobj = otmp;
+  obj_after(obj, otmp);
   if (obj->unpaid)
     splitbill(obj, otmp);
   return (otmp);
@@ -492,9 +501,11 @@ void more_experienced(int exp, int rexp) {
 }
 
 void set_wounded_legs(long side, int timex) {
-  if (!Wounded_legs || (Wounded_legs & TIMEOUT))
-    Wounded_legs |= side + timex;
-  else
+  if (!Wounded_legs || (Wounded_legs & TIMEOUT)) {
+    /* MODERN: was Wounded_legs |= side + timex, see hack.timeout.c */
+    set_utimeout(WOUNDED_LEGS, utimeout(WOUNDED_LEGS) | timex);
+    Wounded_legs |= side;
+  } else
     Wounded_legs |= side;
 }
 
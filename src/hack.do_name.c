@@ -131,7 +131,7 @@ int do_mname(void) {
  * when  obj  is in the inventory.
  */
 void do_oname(struct obj *obj) {
-  struct obj *otmp, *otmp2;
+  struct obj *otmp2;
   int lth;
   char buf[BUFSZ];
   pline("What do you want to name %s? ", doname(obj));
@@ -154,19 +154,11 @@ void do_oname(struct obj *obj) {
 
   /* do freeinv(obj); etc. by hand in order to preserve
      the position of this object in the inventory */
-  if (obj == invent)
-    invent = otmp2;
-  else
-    for (otmp = invent;; otmp = otmp->nobj) {
-      if (!otmp)
-        panic("Do_oname: cannot find obj.");
-      if (otmp->nobj == obj) {
-        otmp->nobj = otmp2;
-        break;
-      }
-    }
+  obj_after(obj, otmp2);
+  if (!obj_unlink(&invent, obj))
+    panic("Do_oname: cannot find obj.");
   /*obfree(obj, otmp2);*/ /* now unnecessary: no pointers on bill */
-  free((char *)obj);      /* let us hope nobody else saved a pointer */
+  lfree((char *)obj);      /* let us hope nobody else saved a pointer */
 }
 
 int ddocall(void) {
@@ -45,15 +45,13 @@ struct monst *fallen_down = 0; /* monsters that fell through a trapdoor */
 void losedogs(void) {
   struct monst *mtmp;
   while ((mtmp = mydogs)) {
-    mydogs = mtmp->nmon;
-    mtmp->nmon = fmon;
-    fmon = mtmp;
+    (void)mon_unlink(&mydogs, mtmp); /* MODERN: see mon_link() */
+    link_monster(mtmp); /* MODERN: was mtmp->nmon = fmon, fmon = mtmp */
     mnexto(mtmp);
   }
   while ((mtmp = fallen_down)) {
-    fallen_down = mtmp->nmon;
-    mtmp->nmon = fmon;
-    fmon = mtmp;
+    (void)mon_unlink(&fallen_down, mtmp); /* MODERN: see mon_link() */
+    link_monster(mtmp); /* MODERN: was mtmp->nmon = fmon, fmon = mtmp */
     rloc(mtmp);
   }
 }
@@ -64,8 +62,7 @@ void keepdogs(void) {
     if (dist(mtmp->mx, mtmp->my) < 3 && follower(mtmp) && !mtmp->msleep &&
         !mtmp->mfroz) {
       relmon(mtmp);
-      mtmp->nmon = mydogs;
-      mydogs = mtmp;
+      mon_link(&mydogs, mtmp); /* MODERN: was mtmp->nmon = mydogs, ... */
       unpmon(mtmp);
       keepdogs(); /* we destroyed the link, so use recursion */
       return;     /* (admittedly somewhat primitive) */
@@ -74,8 +71,7 @@ void keepdogs(void) {
 
 void fall_down(struct monst *mtmp) {
   relmon(mtmp);
-  mtmp->nmon = fallen_down;
-  fallen_down = mtmp;
+  mon_link(&fallen_down, mtmp); /* MODERN: keeps the back-links */
   unpmon(mtmp);
   mtmp->mtame = 0;
 }
@@ -384,8 +380,7 @@ newdogpos:
       (void)hitu(mtmp, d(mdat->damn, mdat->damd) + 1);
       return (0);
     }
-    mtmp->mx = nix;
-    mtmp->my = niy;
+    place_monster(mtmp, nix, niy); /* MODERN: was mx = nix, my = niy */
     for (j = MTSZ - 1; j > 0; j--)
       mtmp->mtrack[j] = mtmp->mtrack[j - 1];
     mtmp->mtrack[0].x = omx;
@@ -90,7 +90,7 @@ int opentin(void) {
     pline(tintxts[r].txt);
     lesshungry(tintxts[r].nut);
     if (r == 1) /* SALMON */ {
-      Glib = rnd(15);
+      set_utimeout(GLIB, (long)rnd(15)); /* MODERN: was Glib = rnd(15) */
       pline("Eating salmon made your fingers very slippery.");
     }
   } else {
@@ -129,7 +129,8 @@ int doeat(void) {
               (otmp->quan == 1) ? "it" : "one");
         if (readchar() == 'y') {
           if (otmp->quan != 1)
-            (void)splitobj(otmp, 1);
+            /* MODERN: the remainder stays on the floor - index it */
+            place_object(splitobj(otmp, 1), otmp->ox, otmp->oy);
           freeobj(otmp);
           otmp = addinv(otmp);
           addtobill(otmp);
@@ -197,10 +198,10 @@ gotit:
     pline("Blecch!  Rotten food!");
     if (!rn2(4)) {
       pline("You feel rather light headed.");
-      Confusion += d(2, 4);
+      incr_utimeout(CONFUSION, (long)d(2, 4)); /* MODERN: was += */
     } else if (!rn2(4) && !Blind) {
       pline("Everything suddenly goes dark.");
-      Blind = d(2, 10);
+      set_utimeout(BLIND, (long)d(2, 10)); /* MODERN: was Blind = */
       seeoff(0);
     } else if (!rn2(3)) {
       if (Blind)
@@ -252,8 +253,8 @@ gotit:
       else
         pline("That %s was delicious!", ftmp->oc_name);
       lesshungry(ftmp->nutrition);
-      if (otmp->otyp == DEAD_LIZARD && (Confusion > 2))
-        Confusion = 2;
+      if (otmp->otyp == DEAD_LIZARD && (utimeout(CONFUSION) > 2))
+        set_utimeout(CONFUSION, 2L); /* MODERN: was Confusion = 2 */
       else
 #ifdef QUEST
           if (otmp->otyp == CARROT && !Blind) {
@@ -414,7 +415,7 @@ int eatcorpse(struct obj *otmp) {
     tp++;
     pline("Ulch -- that meat was tainted!");
     pline("You get very sick.");
-    Sick = 10 + rn2(10);
+    set_utimeout(SICK, (long)(10 + rn2(10))); /* MODERN: was Sick = */
     /* MODERN: Add bounds checking for objects array access */
     /* Note: otyp is uchar, so >= 0 check is redundant */
     if (otmp->otyp < NROFOBJECTS) {
@@ -457,7 +458,7 @@ int eatcorpse(struct obj *otmp) {
     break;
   case 'I':
     if (!Invis) {
-      Invis = 50 + rn2(100);
+      set_utimeout(INVIS, (long)(50 + rn2(100))); /* MODERN: was Invis = */
       if (!See_invisible)
         newsym(u.ux, u.uy);
     } else {
@@ -471,7 +472,7 @@ int eatcorpse(struct obj *otmp) {
 #endif /* QUEST */
        /* fallthrough */
   case 'B':
-    Confusion = 50;
+    set_utimeout(CONFUSION, 50L); /* MODERN: was Confusion = 50 */
     break;
   case 'D':
     Fire_resistance |= INTRINSIC;
@@ -10,12 +10,10 @@
  */
 
 #include "hack.h"
+#include "def.topten.h"
 #include <signal.h>
 #include <stdio.h>
 #include <unistd.h>
-/* MODERN ADDITION (2025): Added for stale lock detection - stat() and time() */
-#include <sys/stat.h>
-#include <time.h>
 /* MODERN: Safe sprintf replacement - same interface, prevents overflow */
 /* MODERN ADDITION (2025): Bounds-safe sprintf replacement for outentry function
  */
@@ -69,6 +67,7 @@ int doquit(void) {
 
 void done1(int sig) {
   (void)sig;
+  jr_intr(); /* MODERN: a replay must quit at the same point */
   doquit();
 }
 
@@ -249,7 +248,8 @@ void done(const char *st1) {
 #ifdef WIZARD
   if (!wizard)
 #endif /* WIZARD */
-    topten();
+    if (jr_mode != JR_REPLAY) /* MODERN: a replay scored already */
+      topten();
   if (done_stopprint)
     printf("\n\n");
 
@@ -259,32 +259,13 @@ void done(const char *st1) {
   exit(0);
 }
 
-/**
- * MODERN: Expanded buffer sizes for modern systems */
-#define NAMSZ 64 /* MODERN: Expanded from 8 to handle modern usernames */
-#define DTHSZ                                                                  \
-  128 /* MODERN: Expanded from 40 to prevent death message truncation */
-#define PERSMAX 1
-#define POINTSMIN 1  /* must be > 0 */
-#define ENTRYMAX 100 /* must be >= 10 */
-#define PERS_IS_UID  /* delete for PERSMAX per name; now per uid */
-struct toptenentry {
-  struct toptenentry *tt_next;
-  long int points;
-  int level, maxlvl, hp, maxhp;
-  int uid;
-  char plchar;
-  char sex;
-  char name[NAMSZ + 1];
-  char death[DTHSZ + 1];
-  char date[7]; /* yymmdd */
-} *tt_head;
+struct toptenentry *tt_head;
 
 /* MODERN: Static arena allocator to prevent memory leaks */
 static struct toptenentry arena[ENTRYMAX + 2]; /* +2 for t0 and safety margin */
 static int arena_used = 0;
 
-static void reset_topten_arena(void) {
+void reset_topten_arena(void) {
   arena_used = 0;
   memset(arena, 0, sizeof(arena));
 }
@@ -299,87 +280,81 @@ struct toptenentry *newttentry(void) {
 /* Forward declaration after struct definition */
 int outentry(int rank, struct toptenentry *t1, int so);
 
+/* MODERN: index of the first entry scoring fewer points than 'points' */
+static int ttrank(struct toptenentry **ents, int n, long points) {
+  int lo = 0, hi = n, mid;
+  while (lo < hi) {
+    mid = (lo + hi) / 2;
+    if (ents[mid]->points < points)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return lo;
+}
+
+/*
+ * MODERN: Merge t0 into the ranked ents[0..n-1], leaving the new list in
+ * list[] and returning its length. *rank0: -1 undefined, 0 not_on_list,
+ * n n_th on list; *rank1 is the rank of the entry t0 did not beat; *flg
+ * is set when the list changed and has to be written back.
+ */
+int ttmerge(struct toptenentry **ents, int n, struct toptenentry *t0,
+            struct toptenentry **list, int *rank0, int *rank1, int *flg) {
+  struct toptenentry *t1;
+  int occ_cnt = PERSMAX;
+  int pos, i, m = 0;
+
+  *rank0 = -1;
+  *rank1 = 0;
+  *flg = 0;
+  /* MODERN: the list is in rank order, so find t0's place by bisection */
+  pos = ttrank(ents, n, t0->points);
+  for (i = 0; i <= n && m < ENTRYMAX; i++) {
+    if (i == pos && *rank0 < 0 && t0->points > 0) {
+      list[m++] = t0;
+      *rank0 = m;
+      occ_cnt--;
+      (*flg)++; /* ask for a rewrite */
+      if (m >= ENTRYMAX)
+        break;
+    }
+    if (i == n)
+      break;
+    t1 = ents[i];
+    if (
+#ifdef PERS_IS_UID
+        t1->uid == t0->uid &&
+#else
+        strncmp(t1->name, t0->name, NAMSZ) == 0 &&
+#endif /* PERS_IS_UID */
+        t1->plchar == t0->plchar && --occ_cnt <= 0) {
+      if (*rank0 < 0) {
+        *rank0 = 0;
+        *rank1 = m + 1;
+      }
+      if (occ_cnt < 0) {
+        (*flg)++;
+        continue;
+      }
+    }
+    list[m++] = t1;
+  }
+  return m;
+}
+
 void topten(void) {
   reset_topten_arena(); /* MODERN: Reset arena for fresh allocation */
   int uid = getuid();
   int rank, rank0 = -1, rank1 = 0;
-  int occ_cnt = PERSMAX;
-  struct toptenentry *t0, *t1, *tprev;
-  const char *recfile =
-      RECORD; /* MODERN: const because points to string literal */
-  const char *reclock =
-      "record_lock"; /* MODERN: const because points to string literal */
-  (void)reclock;     /* Original 1984: used in link() locking, conditionally
-                        compiled */
-  int sleepct = 300;
-  (void)sleepct; /* Original 1984: used in link() retry loop, conditionally
-                    compiled */
-  FILE *rfile;
-  int flg = 0;
+  static struct toptenentry t0buf; /* MODERN: outlives arena resets */
+  struct toptenentry *t0 = &t0buf, *t1;
+  struct toptenentry *list[ENTRYMAX];
+  int m, i;
   extern char *getdatestr();
 #define HUP if (!done_hup)
 
-  /**
-   * MODERN ADDITION (2025): Stale lock detection and cleanup
-   *
-   * WHY: Original 1984 code could leave stale record_lock files if the game
-   * crashed or was killed before proper cleanup, causing infinite loops in
-   * subsequent runs waiting for lock release.
-   *
-   * HOW: Check if record_lock exists and is older than 5 minutes (300 seconds).
-   * If so, assume it's stale from a crashed process and remove it
-   * automatically. Uses stat() to get file modification time and compare with
-   * current time.
-   *
-   * PRESERVES: Original Unix file locking semantics using link() for atomicity
-   * ADDS: Defensive programming against stale resources
-   */
-  struct stat lockstat;
-  (void)lockstat; /* Original 1984: used for stale lock detection, conditionally
-                     compiled */
-#ifdef ENABLE_MODERN_LOCKING
-  /* Modern locking: flock() automatically releases on process death */
-  /* No stale locks to clean up */
-#else
-  /* Original 1984 system: Clean up stale record locks */
-  if (stat(reclock, &lockstat) == 0) {
-    time_t now = time(NULL);
-    if (now - lockstat.st_mtime > 300) { /* 5 minutes */
-      HUP printf("Removing stale record lock (age: %ld seconds)\n",
-                 (long)(now - lockstat.st_mtime));
-      (void)unlink(reclock);
-    }
-  }
-#endif
-
-#ifdef ENABLE_MODERN_LOCKING
-  /* MODERN ADDITION (2025): Use flock()-based record locking */
-  if (!modern_lock_record()) {
-    HUP puts("Cannot access record file!");
-    return;
-  }
-#else
-  /* Original 1984 link()-based record locking */
-  while (link(recfile, reclock) == -1) {
-    HUP perror(reclock);
-    if (!sleepct--) {
-      HUP puts("I give up. Sorry.");
-      HUP puts("Perhaps there is an old record_lock around?");
-      return;
-    }
-    HUP printf("Waiting for access to record file. (%d)\n", sleepct);
-    HUP(void) fflush(stdout);
-    sleep(1);
-  }
-#endif
-  if (!(rfile = fopen(recfile, "r"))) {
-    HUP puts("Cannot open record file!");
-    goto unlock;
-  }
-  HUP(void) putchar('\n');
-
   /* create a new 'topten' entry */
-  t0 = newttentry();
   t0->level = dlevel;
   t0->maxlvl = maxdlevel;
   t0->hp = u.uhp;
@@ -400,71 +375,40 @@ void topten(void) {
   if (t0->points < POINTSMIN)
     t0->points = 0;
 
-  t1 = tt_head = newttentry();
-  tprev = 0;
-  /* rank0: -1 undefined, 0 not_on_list, n n_th on list */
-  for (rank = 1;;) {
-    if (fscanf(rfile, "%6s %d %d %d %d %d %ld %c%c %64[^,],%128[^\n]", t1->date,
-               &t1->uid, &t1->level, &t1->maxlvl, &t1->hp, &t1->maxhp,
-               &t1->points, &t1->plchar, &t1->sex, t1->name, t1->death) != 11 ||
-        t1->points < POINTSMIN)
-      t1->points = 0;
-    if (rank0 < 0 && t1->points < t0->points) {
-      rank0 = rank++;
-      if (tprev == 0)
-        tt_head = t0;
-      else
-        tprev->tt_next = t0;
-      t0->tt_next = t1;
-      occ_cnt--;
-      flg++; /* ask for a rewrite */
-    } else
-      tprev = t1;
-    if (t1->points == 0)
-      break;
-    if (
-#ifdef PERS_IS_UID
-        t1->uid == t0->uid &&
-#else
-        strncmp(t1->name, t0->name, NAMSZ) == 0 &&
-#endif /* PERS_IS_UID */
-        t1->plchar == t0->plchar && --occ_cnt <= 0) {
-      if (rank0 < 0) {
-        rank0 = 0;
-        rank1 = rank;
-        HUP printf("You didn't beat your previous score of %ld points.\n\n",
-                   t1->points);
-      }
-      if (occ_cnt < 0) {
-        flg++;
-        continue;
-      }
-    }
-    if (rank <= ENTRYMAX) {
-      t1 = t1->tt_next = newttentry();
-      rank++;
-    }
-    if (rank > ENTRYMAX) {
-      t1->points = 0;
-      break;
-    }
+  /* MODERN: ranked on a snapshot; the record lock covers only the publish */
+  m = rec_score(t0, list, &rank0, &rank1, FALSE);
+  if (m == REC_NOLOCK) {
+    HUP puts("Cannot access record file!");
+    return;
+  }
+  if (m == REC_NOREAD) {
+    HUP puts("Cannot open record file!");
+    return;
   }
-  if (flg) { /* rewrite record file */
-    (void)fclose(rfile);
-    if (!(rfile = fopen(recfile, "w"))) {
-      HUP puts("Cannot write record file\n");
-      goto unlock;
+  if (m == REC_NOWRITE) {
+    HUP puts("Cannot write record file\n");
+    return;
+  }
+  HUP(void) putchar('\n');
+  if (rank1)
+    HUP printf("You didn't beat your previous score of %ld points.\n\n",
+               list[rank1 - 1]->points);
+  if (!done_stopprint)
+    if (rank0 > 0) {
+      if (rank0 <= 10)
+        puts("You made the top ten list!\n");
+      else
+        printf("You reached the %d%s place on the top %d list.\n\n", rank0,
+               ordin(rank0), ENTRYMAX);
     }
 
-    if (!done_stopprint)
-      if (rank0 > 0) {
-        if (rank0 <= 10)
-          puts("You made the top ten list!\n");
-        else
-          printf("You reached the %d%s place on the top %d list.\n\n", rank0,
-                 ordin(rank0), ENTRYMAX);
-      }
+  /* MODERN: chain the list up for the display below, ending in a 0 entry */
+  tt_head = newttentry();
+  for (i = m - 1; i >= 0; i--) {
+    list[i]->tt_next = tt_head;
+    tt_head = list[i];
   }
+  rank = m + 1;
   if (rank0 == 0)
     rank0 = rank1;
   if (rank0 <= 0)
@@ -473,10 +417,6 @@ void topten(void) {
     outheader();
   t1 = tt_head;
   for (rank = 1; t1->points != 0; rank++, t1 = t1->tt_next) {
-    if (flg)
-      fprintf(rfile, "%6s %d %d %d %d %d %ld %c%c %s,%s\n", t1->date, t1->uid,
-              t1->level, t1->maxlvl, t1->hp, t1->maxhp, t1->points, t1->plchar,
-              t1->sex, t1->name, t1->death);
     if (done_stopprint)
       continue;
     if (rank >
@@ -512,15 +452,6 @@ void topten(void) {
   if (rank0 >= rank)
     if (!done_stopprint)
       (void)outentry(0, t0, 1);
-  (void)fclose(rfile);
-unlock:
-  /* Original 1984 code had no cleanup as program exits immediately after
-   * topten() */
-#ifdef ENABLE_MODERN_LOCKING
-  modern_unlock_record();
-#else
-  (void)unlink(reclock);
-#endif
 }
 
 void outheader(void) {
@@ -719,10 +650,9 @@ void prscore(int argc, char **argv) {
   char **players;
   int playerct;
   int rank;
-  struct toptenentry *t1, *t2;
-  const char *recfile =
-      RECORD; /* MODERN: const because points to string literal */
-  FILE *rfile;
+  struct toptenentry *t1;
+  struct toptenentry *ents[ENTRYMAX];
+  int n;
   int flg = 0;
   int i;
 #ifdef nonsense
@@ -737,7 +667,7 @@ void prscore(int argc, char **argv) {
   char *player0;
 #endif /* PERS_IS_UID */
 
-  if (!(rfile = fopen(recfile, "r"))) {
+  if ((n = rec_load(ents)) < 0) {
     puts("Cannot open record file!");
     return;
   }
@@ -770,14 +700,8 @@ void prscore(int argc, char **argv) {
   if (outflg)
     putchar('\n');
 
-  t1 = tt_head = newttentry();
-  for (rank = 1;; rank++) {
-    if (fscanf(rfile, "%6s %d %d %d %d %d %ld %c%c %64[^,],%128[^\n]", t1->date,
-               &t1->uid, &t1->level, &t1->maxlvl, &t1->hp, &t1->maxhp,
-               &t1->points, &t1->plchar, &t1->sex, t1->name, t1->death) != 11)
-      t1->points = 0;
-    if (t1->points == 0)
-      break;
+  for (rank = 1; rank <= n; rank++) {
+    t1 = ents[rank - 1];
 #ifdef PERS_IS_UID
     if (!playerct && t1->uid == uid)
       flg++;
@@ -791,9 +715,7 @@ void prscore(int argc, char **argv) {
             (digit(players[i][0]) && rank <= atoi(players[i])))
           flg++;
       }
-    t1 = t1->tt_next = newttentry();
   }
-  (void)fclose(rfile);
   if (!flg) {
     if (outflg) {
       printf("Cannot find any entries for ");
@@ -812,9 +734,8 @@ void prscore(int argc, char **argv) {
 
   if (outflg)
     outheader();
-  t1 = tt_head;
-  for (rank = 1; t1->points != 0; rank++, t1 = t2) {
-    t2 = t1->tt_next;
+  for (rank = 1; rank <= n; rank++) {
+    t1 = ents[rank - 1];
 #ifdef PERS_IS_UID
     if (!playerct && t1->uid == uid)
       goto outwithit;
@@ -837,7 +758,6 @@ void prscore(int argc, char **argv) {
           break;
         }
       }
-    free((char *)t1);
   }
 #ifdef nonsense
   totchars[totcharct] = 0;
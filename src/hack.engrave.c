@@ -128,7 +128,7 @@ void make_engr_at(int x, int y, const char *s) {
 
   if ((ep = engr_at(x, y)))
     del_engr(ep);
-  ep = (struct engr *)alloc((unsigned)(sizeof(struct engr) + strlen(s) + 1));
+  ep = (struct engr *)lalloc((unsigned)(sizeof(struct engr) + strlen(s) + 1));
   ep->nxt_engr = head_engr;
   head_engr = ep;
   ep->engr_x = x;
@@ -267,7 +267,7 @@ int doengrave(void) {
     }
     len += existing_len + spct;
   }
-  ep = (struct engr *)alloc((unsigned)(sizeof(struct engr) + len + 1));
+  ep = (struct engr *)lalloc((unsigned)(sizeof(struct engr) + len + 1));
   ep->nxt_engr = head_engr;
   head_engr = ep;
   ep->engr_x = u.ux;
@@ -336,7 +336,7 @@ void rest_engravings(int fd) {
     if (lth > 32767 || lth > UINT_MAX - sizeof(struct engr)) {
       error("Save file corrupted: invalid engraving size");
     }
-    ep = (struct engr *)alloc(sizeof(struct engr) + lth);
+    ep = (struct engr *)lalloc(sizeof(struct engr) + lth);
     mread(fd, (char *)ep, sizeof(struct engr) + lth);
     ep->nxt_engr = head_engr;
     ep->engr_txt = (char *)(ep + 1); /* Andreas Bormann */
@@ -344,6 +344,115 @@ void rest_engravings(int fd) {
   }
 }
 
+/* MODERN: hand the level's engravings to the level cache (hack.lev.c) */
+struct engr *stash_engravings(void) {
+  struct engr *ep = head_engr;
+
+  head_engr = 0;
+  return (ep);
+}
+
+/*
+ * Take them back. With reorder the chain comes out as a save and
+ * rest_engravings() would leave it: empty engravings gone, order reversed.
+ */
+void unstash_engravings(struct engr *ep, boolean reorder) {
+  struct engr *ep2;
+
+  if (!reorder) {
+    head_engr = ep;
+    return;
+  }
+  head_engr = 0;
+  for (; ep; ep = ep2) {
+    ep2 = ep->nxt_engr;
+    if (!ep->engr_lth || !ep->engr_txt[0]) {
+      lfree((char *)ep);
+      continue;
+    }
+    ep->nxt_engr = head_engr;
+    head_engr = ep;
+  }
+}
+
+/* MODERN: free a stashed chain of engravings, see pregen_free() */
+void free_engravings(struct engr *ep) {
+  struct engr *ep2;
+
+  for (; ep; ep = ep2) {
+    ep2 = ep->nxt_engr;
+    lfree((char *)ep);
+  }
+}
+
+/* MODERN: move the current level's engravings dmoves later, see pregen_take() */
+void date_engravings(long dmoves) {
+  struct engr *ep;
+
+  for (ep = head_engr; ep; ep = ep->nxt_engr)
+    ep->engr_time += dmoves;
+}
+
+unsigned long engravings_size(struct engr *ep) {
+  unsigned long size = 0;
+
+  for (; ep; ep = ep->nxt_engr)
+    size += sizeof(struct engr) + ep->engr_lth;
+  return (size);
+}
+
+/*
+ * MODERN: the engravings as level image records (hack.levimg.c), the text
+ * in the image's text section; freed as save_engravings() dropped them.
+ */
+void engr_image(struct limg *rec) {
+  struct engr *ep, *ep2;
+
+  for (ep = head_engr; ep; ep = ep2) {
+    ep2 = ep->nxt_engr;
+    if (ep->engr_lth && ep->engr_txt[0]) {
+      li_put(rec, (uchar)ep->engr_x, 1);
+      li_put(rec, (uchar)ep->engr_y, 1);
+      li_put(rec, (uchar)ep->engr_type, 1);
+      li_put(rec, 0, 1);
+      li_put(rec, ep->engr_lth, 4);
+      li_long(rec, ep->engr_time);
+      li_put(rec, li_text(ep->engr_txt, ep->engr_lth), 4);
+    }
+    lfree((char *)ep);
+  }
+  head_engr = 0;
+}
+
+/* one record back, in front as rest_engravings() put it */
+void engr_unimage(struct lrd *rec) {
+  struct engr *ep;
+  struct lrd t;
+  xchar x, y, type;
+  unsigned lth;
+  long time;
+
+  x = (xchar)li_get(rec, 1);
+  y = (xchar)li_get(rec, 1);
+  li_onmap(x, y);
+  type = (xchar)li_get(rec, 1);
+  (void)li_get(rec, 1);
+  lth = (unsigned)li_get(rec, 4);
+  time = li_getlong(rec);
+  li_gettext((unsigned)li_get(rec, 4), lth, &t);
+  ep = (struct engr *)lalloc(sizeof(struct engr) + (lth ? lth : 1));
+  ep->engr_x = x;
+  ep->engr_y = y;
+  ep->engr_type = type;
+  ep->engr_lth = lth;
+  ep->engr_time = time;
+  ep->engr_txt = (char *)(ep + 1);
+  li_getbytes(&t, ep->engr_txt, lth);
+  ep->engr_txt[lth ? lth - 1 : 0] = '\0'; /* lth counts the NUL */
+  ep->nxt_engr = head_engr;
+  head_engr = ep;
+}
+
 void del_engr(struct engr *ep) {
   struct engr *ept;
   if (ep == head_engr)
@@ -359,7 +468,7 @@ void del_engr(struct engr *ep) {
     return;
   fnd:;
   }
-  free((char *)ep);
+  lfree((char *)ep);
 }
 
 /**
@@ -369,7 +478,7 @@ void cleanup_all_engravings(void) {
 
   for (ep = head_engr; ep; ep = next) {
     next = ep->nxt_engr;
-    free((char *)ep);
+    lfree((char *)ep);
   }
   head_engr = NULL;
 }
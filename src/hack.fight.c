@@ -117,13 +117,17 @@ void monstone(struct monst *mdef) {
 
 int fightm(struct monst *mtmp) {
   struct monst *mon;
+  int ret = -1, rs = rnd_use(RS_COMBAT); /* MODERN: own random stream, see rnd.c */
   for (mon = fmon; mon; mon = mon->nmon)
     if (mon != mtmp) {
       if (DIST(mon->mx, mon->my, mtmp->mx, mtmp->my) < 3)
-        if (rn2(4))
-          return (hitmm(mtmp, mon));
+        if (rn2(4)) {
+          ret = hitmm(mtmp, mon);
+          break;
+        }
     }
-  return (-1);
+  (void)rnd_use(rs);
+  return (ret);
 }
 
 /* u is hit by sth, but not a monster */
@@ -148,8 +152,8 @@ int thitu(int tlev, int dam, const char *name) {
 
 char mlarge[] = "bCDdegIlmnoPSsTUwY',&";
 
-boolean hmon(struct monst *mon, struct obj *obj,
-             int thrown) /* return TRUE if mon still alive */
+static boolean hmon1(struct monst *mon, struct obj *obj,
+                     int thrown) /* return TRUE if mon still alive */
 {
   int tmp;
   boolean hittxt = FALSE;
@@ -282,9 +286,17 @@ boolean hmon(struct monst *mon, struct obj *obj,
   return (TRUE); /* mon still alive */
 }
 
+boolean hmon(struct monst *mon, struct obj *obj, int thrown) {
+  int rs = rnd_use(RS_COMBAT); /* MODERN: own random stream, see rnd.c */
+  boolean alive = hmon1(mon, obj, thrown);
+
+  (void)rnd_use(rs);
+  return (alive);
+}
+
 /* try to attack; return FALSE if monster evaded */
 /* u.dx and u.dy must be set */
-int attack(struct monst *mtmp) {
+static int attack1(struct monst *mtmp) {
   schar tmp;
   boolean malive = TRUE;
   struct permonst *mdat;
@@ -406,3 +418,11 @@ int attack(struct monst *mtmp) {
   }
   return (TRUE);
 }
+
+int attack(struct monst *mtmp) {
+  int rs = rnd_use(RS_COMBAT); /* MODERN: own random stream, see rnd.c */
+  int ret = attack1(mtmp);
+
+  (void)rnd_use(rs);
+  return (ret);
+}
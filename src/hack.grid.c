@@ -0,0 +1,311 @@
+/* hack.grid.c - Per-cell occupancy index for the current level
+ *
+ * MODERN ADDITION (2026): Answers "what is at (x,y)" without walking the
+ * level's entity chains.
+ *
+ * WHY: m_at() walked fmon and every worm tail on each call, and it is called
+ * for every neighbour square a monster considers moving to (mfndpos()), for
+ * every square of every zap, and from goodpos() while placing monsters. On a
+ * crowded level that is quadratic work every turn. o_at(), sobj_at(), g_at()
+ * and t_at() - called for every square the display redraws and every
+ * square a monster considers - walked fobj, fgold and ftrap the same way.
+ *
+ * HOW: mongrid[][] holds the monster standing on, or whose worm tail covers,
+ * each square of the level in memory; seggrid[][] holds the tail segment for
+ * squares covered by a tail. Every place that moves a monster goes through
+ * place_monster(), relmon() drops the monster from its square, and the worm
+ * code keeps the tail squares. getlev() rebuilds the grid from the restored
+ * chains and savelev() empties it.
+ *
+ * Objects keep their single fobj chain, so objgrid[][] holds the first
+ * object of each square in fobj order and objcount[][] how many lie there;
+ * sobj_at() walks the chain from that first object and stops once it has
+ * seen them all. Whatever links an object into fobj or moves one already
+ * there calls place_object(); freeobj() calls remove_object(). Linking an
+ * object into fobj gives it an order number between its neighbours'
+ * (order_object()), so place_object() sees which of two objects comes first
+ * in fobj by comparing numbers instead of walking the chain. The number is
+ * kept in the object's chain header (struct lchain in alloc.c), in a word
+ * a monster's header pads its id with; no other block carries one. Gold (one
+ * pile per square, mkgold() merges) and traps get a head per square.
+ *
+ * PRESERVES: m_at() and m_atseg answer as before - a monster on the square
+ * wins over a tail segment, the worm's own head square reports no segment.
+ * o_at(), sobj_at(), g_at() and t_at() return the same entity the chain walk
+ * found first. The chains stay the authority for saving and iteration.
+ * ADDS: O(1) m_at(), o_at(), g_at(), t_at(); sobj_at() in the pile size.
+ */
+
+#include "hack.h"
+#ifndef NOWORM
+#include "def.wseg.h"
+#endif /* NOWORM */
+
+#include <limits.h>
+#include <stddef.h>
+
+static struct monst *mongrid[COLNO][ROWNO];
+#ifndef NOWORM
+static struct wseg *seggrid[COLNO][ROWNO];
+#endif /* NOWORM */
+static struct obj *objgrid[COLNO][ROWNO];
+/* objects per square; not a short, which a pile of 65536 would wrap */
+static unsigned objcount[COLNO][ROWNO];
+static struct gold *goldgrid[COLNO][ROWNO];
+static struct trap *trapgrid[COLNO][ROWNO];
+
+#define ongrid(x, y) ((x) > 0 && (x) < COLNO && (y) >= 0 && (y) < ROWNO)
+
+struct monst *mon_grid_at(int x, int y, struct wseg **segp) {
+  if (!ongrid(x, y)) {
+    *segp = 0;
+    return (0);
+  }
+#ifndef NOWORM
+  *segp = seggrid[x][y];
+#else
+  *segp = 0;
+#endif /* NOWORM */
+  return (mongrid[x][y]);
+}
+
+/* move mtmp to (x,y); x == 0 takes it off the map */
+void place_monster(struct monst *mtmp, int x, int y) {
+  remove_monster(mtmp);
+  mtmp->mx = (xchar)x;
+  mtmp->my = (xchar)y;
+  if (ongrid(x, y)) {
+    mongrid[x][y] = mtmp;
+#ifndef NOWORM
+    seggrid[x][y] = 0;
+#endif /* NOWORM */
+  }
+}
+
+void remove_monster(struct monst *mtmp) {
+  int x = mtmp->mx, y = mtmp->my;
+
+  if (ongrid(x, y) && mongrid[x][y] == mtmp
+#ifndef NOWORM
+      && !seggrid[x][y]
+#endif /* NOWORM */
+  )
+    mongrid[x][y] = 0;
+}
+
+#ifndef NOWORM
+/* wtmp is a tail segment (not the head) of worm mtmp */
+void place_wseg(struct wseg *wtmp, struct monst *mtmp) {
+  int x = wtmp->wx, y = wtmp->wy;
+
+  if (ongrid(x, y)) {
+    mongrid[x][y] = mtmp;
+    seggrid[x][y] = wtmp;
+  }
+}
+
+void remove_wseg(struct wseg *wtmp) {
+  int x = wtmp->wx, y = wtmp->wy;
+
+  if (ongrid(x, y) && seggrid[x][y] == wtmp) {
+    mongrid[x][y] = 0;
+    seggrid[x][y] = 0;
+  }
+}
+
+/* (re)enter the tail of worm mtmp; the head square belongs to mtmp itself */
+void place_worm(struct monst *mtmp) {
+  struct wseg *wtmp;
+
+  if (mtmp->wormno <= 0 || mtmp->wormno >= 32)
+    return;
+  for (wtmp = wsegs[mtmp->wormno]; wtmp && wtmp->nseg; wtmp = wtmp->nseg)
+    place_wseg(wtmp, mtmp);
+}
+#endif /* NOWORM */
+
+struct obj *obj_grid_at(int x, int y) {
+  return (ongrid(x, y) ? objgrid[x][y] : 0);
+}
+
+struct obj *sobj_grid_at(int n, int x, int y) {
+  struct obj *otmp;
+  int left;
+
+  if (!ongrid(x, y))
+    return (0);
+  left = objcount[x][y];
+  for (otmp = objgrid[x][y]; otmp && left; otmp = otmp->nobj)
+    if (otmp->ox == x && otmp->oy == y) {
+      if (otmp->otyp == n)
+        return (otmp);
+      left--;
+    }
+  return (0);
+}
+
+#define OSEQ_GAP 4096U /* room left between objects numbered afresh */
+
+/* number the objects in fobj afresh, in chain order; objects are linked in
+   at the front far more often than anywhere else, so start in the middle */
+static void renumber_fobj(void) {
+  struct obj *otmp;
+  unsigned seq = UINT_MAX / 2;
+
+  for (otmp = fobj; otmp; otmp = otmp->nobj, seq += OSEQ_GAP)
+    lsetseq(otmp, seq);
+}
+
+/* obj was just linked into fobj: number it between its neighbours */
+void order_object(struct obj *obj) {
+  struct obj **link = (struct obj **)LBACK(obj);
+  unsigned lo = 0, hi = UINT_MAX, seq;
+
+  if (link != &fobj) /* link is the nobj of the object before it */
+    lo = lgetseq((char *)link - offsetof(struct obj, nobj));
+  if (obj->nobj)
+    hi = lgetseq(obj->nobj);
+  if (link == &fobj && !obj->nobj) /* the only one */
+    seq = UINT_MAX / 2;
+  else if (link == &fobj)
+    seq = hi > OSEQ_GAP ? hi - OSEQ_GAP : hi / 2;
+  else if (!obj->nobj && lo < UINT_MAX - OSEQ_GAP)
+    seq = lo + OSEQ_GAP;
+  else
+    seq = lo + (hi - lo) / 2;
+  if (seq == lo || seq == hi) /* no number left in between */
+    renumber_fobj();
+  else
+    lsetseq(obj, seq);
+}
+
+/* obj is linked into fobj: put it at (x,y) */
+void place_object(struct obj *obj, int x, int y) {
+  obj->ox = (xchar)x;
+  obj->oy = (xchar)y;
+  if (!ongrid(x, y))
+    return;
+  /* it is first here if the old first object comes after it in fobj */
+  if (objcount[x][y]++ == 0 || lgetseq(obj) < lgetseq(objgrid[x][y]))
+    objgrid[x][y] = obj;
+}
+
+/* obj leaves its square; obj->nobj must still be its old successor */
+void remove_object(struct obj *obj) {
+  struct obj *otmp;
+  int x = obj->ox, y = obj->oy;
+
+  if (!ongrid(x, y) || !objcount[x][y])
+    return;
+  objcount[x][y]--;
+  if (objgrid[x][y] != obj)
+    return;
+  objgrid[x][y] = 0;
+  if (objcount[x][y])
+    for (otmp = obj->nobj; otmp; otmp = otmp->nobj)
+      if (otmp->ox == x && otmp->oy == y) {
+        objgrid[x][y] = otmp;
+        break;
+      }
+}
+
+struct gold *gold_grid_at(int x, int y) {
+  return (ongrid(x, y) ? goldgrid[x][y] : 0);
+}
+
+/* gold is linked into fgold */
+void place_gold(struct gold *gold, int x, int y) {
+  gold->gx = (xchar)x;
+  gold->gy = (xchar)y;
+  if (ongrid(x, y))
+    goldgrid[x][y] = gold;
+}
+
+void remove_gold(struct gold *gold) {
+  int x = gold->gx, y = gold->gy;
+
+  if (ongrid(x, y) && goldgrid[x][y] == gold)
+    goldgrid[x][y] = 0;
+}
+
+struct trap *trap_grid_at(int x, int y) {
+  return (ongrid(x, y) ? trapgrid[x][y] : 0);
+}
+
+/* trap has just been put at the head of ftrap */
+void place_trap(struct trap *trap) {
+  int x = trap->tx, y = trap->ty;
+
+  if (ongrid(x, y))
+    trapgrid[x][y] = trap;
+}
+
+/* trap leaves ftrap; trap->ntrap must still be its old successor */
+void remove_trap(struct trap *trap) {
+  struct trap *ttmp;
+  int x = trap->tx, y = trap->ty;
+
+  if (!ongrid(x, y) || trapgrid[x][y] != trap)
+    return;
+  trapgrid[x][y] = 0;
+  for (ttmp = trap->ntrap; ttmp; ttmp = ttmp->ntrap)
+    if (ttmp->tx == x && ttmp->ty == y) {
+      trapgrid[x][y] = ttmp;
+      break;
+    }
+}
+
+void clear_grid(void) {
+  memset(mongrid, 0, sizeof(mongrid));
+#ifndef NOWORM
+  memset(seggrid, 0, sizeof(seggrid));
+#endif /* NOWORM */
+  memset(objgrid, 0, sizeof(objgrid));
+  memset(objcount, 0, sizeof(objcount));
+  memset(goldgrid, 0, sizeof(goldgrid));
+  memset(trapgrid, 0, sizeof(trapgrid));
+}
+
+/* after getlev(): index the restored level */
+void rebuild_grid(void) {
+  struct monst *mtmp;
+  struct obj *otmp;
+  struct gold *gold;
+  struct trap *trap;
+  int x, y;
+
+  clear_grid();
+  renumber_fobj(); /* the chain was restored or spliced by hand */
+  for (mtmp = fmon; mtmp; mtmp = mtmp->nmon) {
+#ifndef NOWORM
+    if (mtmp->wormno)
+      place_worm(mtmp);
+#endif /* NOWORM */
+    x = mtmp->mx;
+    y = mtmp->my;
+    if (ongrid(x, y)) {
+      mongrid[x][y] = mtmp;
+#ifndef NOWORM
+      seggrid[x][y] = 0;
+#endif /* NOWORM */
+    }
+  }
+  for (otmp = fobj; otmp; otmp = otmp->nobj) {
+    x = otmp->ox;
+    y = otmp->oy;
+    if (ongrid(x, y) && !objcount[x][y]++)
+      objgrid[x][y] = otmp;
+  }
+  for (gold = fgold; gold; gold = gold->ngold) {
+    x = gold->gx;
+    y = gold->gy;
+    if (ongrid(x, y) && !goldgrid[x][y])
+      goldgrid[x][y] = gold;
+  }
+  for (trap = ftrap; trap; trap = trap->ntrap) {
+    x = trap->tx;
+    y = trap->ty;
+    if (ongrid(x, y) && !trapgrid[x][y])
+      trapgrid[x][y] = trap;
+  }
+}
@@ -52,6 +52,8 @@ typedef struct {
 
 #define BUFSZ 256  /* for getlin buffers */
 #define PL_NSIZ 32 /* name of player, ghost, shopkeeper */
+#define FRAMEBUFSZ 32768 /* stdout buffer; holds a full redraw (flush_frame) */
+#define LEVCACHE_KB 512  /* levels kept in memory after leaving (levelcache) */
 
 /**
  * MODERN ADDITION (2025): Safe object array access macros
@@ -72,7 +74,24 @@ typedef struct {
 #include "def.permonst.h"
 #include "def.rm.h"
 
+#ifndef ALLOC_STATS /* MODERN: otherwise config.h names their call sites */
 extern void *alloc(unsigned lth);
+extern void *lalloc(unsigned lth);
+extern void *lalloc_chained(unsigned lth, boolean ided);
+extern void *enlarge(char *ptr, unsigned lth);
+#endif /* ALLOC_STATS */
+extern void lfree(void *ptr);
+extern void arena_release(int lev);
+extern void prarenastats(void);
+#define LHDRSZ 16 /* MODERN: the header of a block from lalloc() */
+/* MODERN: the link pointing at a block from lalloc_chained(), see obj_link() */
+#define LBACK(ptr) (((void **)((char *)(ptr) - LHDRSZ))[-1])
+/* MODERN: the head of the chain that link belongs to, see obj_link() */
+#define LHEAD(ptr) (((void **)((char *)(ptr) - LHDRSZ))[-2])
+extern unsigned lgetid(void *ptr);
+extern void lsetid(void *ptr, unsigned id);
+extern unsigned lgetseq(void *ptr);
+extern void lsetseq(void *ptr, unsigned seq);
 /* MODERN: CONST-CORRECTNESS: panic message is read-only */
 /* MODERN: noreturn attribute tells compiler panic() never returns */
 extern void panic(const char *str, ...) __attribute__((noreturn));
@@ -115,6 +134,21 @@ extern int holetime(void);
 extern int rn1(int x, int y);
 extern void fracture_rock(struct obj *obj);
 
+/* RANDOM STREAMS - rnd.c; see rnd_use() */
+#define RS_MISC 0   /* everything not listed below */
+#define RS_LEVEL 1  /* mklev(), see rnd_level() */
+#define RS_ITEM 2   /* mkobj(), mksobj() */
+#define RS_MONST 3  /* makemon(), movemon() */
+#define RS_COMBAT 4 /* mhitu(), attack(), hmon(), fightm() */
+#define RS_NSTREAMS 5
+extern void rnd_seed(unsigned seed);
+extern int rnd_use(int stream);
+extern unsigned long rnd_state(void);
+extern unsigned rnd_game(void);
+extern void rnd_setgame(unsigned seed);
+extern int rnd_level(int lev);
+extern void rnd_level_end(int stream);
+
 /* PLAYER SYSTEM PROTOTYPES - from studying hack.u_init.c */
 /* K&R OBJECT CREATION SYSTEM - Forward declarations for authentic 1984
  * functions */
@@ -153,6 +187,69 @@ extern int xputc(int c);
 extern void cmov(int x, int y);
 extern void nocmov(int x, int y);
 extern void home(void);
+extern void frame_open(char *);
+extern void flush_frame(void);
+extern void prframestats(void);
+extern int xcost(char *s);
+extern void prmovestats(void);
+
+/* SHADOW SCREEN PROTOTYPES - hack.screen.c */
+extern boolean scr_shadow;
+extern void scr_start(void);
+extern void scr_end(void);
+extern void scr_suspend(void);
+extern void scr_resume(void);
+extern void scr_clear(void);
+extern void scr_goto(int x, int y);
+extern void scr_standout(int on);
+extern void scr_putc(int c);
+extern void scr_puts(const char *s);
+extern void scr_clreol(void);
+extern void scr_clreos(void);
+extern void scr_render(void);
+extern int scr_peek(int x, int y);
+extern void scr_text(void);
+extern unsigned scr_hash(void);
+extern boolean headless;
+extern void prscrstats(void);
+
+/* JOURNAL PROTOTYPES - hack.journal.c */
+#define JR_OFF 0
+#define JR_RECORD 1
+#define JR_REPLAY 2
+extern int jr_mode;
+extern void jr_open(const char *file, int mode);
+extern void jr_termsize(int *co, int *li);
+extern void jr_start(void);
+extern void jr_restored(void);
+extern int jr_getchar(void);
+extern int jr_clock(int type, int val);
+extern void jr_intr(void);
+extern boolean jr_resized(void);
+extern void jr_resize(int *co, int *li);
+
+/* LEVEL IMAGE PROTOTYPES - hack.levimg.c */
+struct limg { /* an image (or one of its sections) being written */
+  char *buf;
+  unsigned len, size;
+};
+struct lrd { /* a record being read: exactly its bytes */
+  const unsigned char *p, *end;
+};
+extern void li_put(struct limg *w, unsigned long v, int width);
+extern void li_long(struct limg *w, long v);
+extern void li_bytes(struct limg *w, const char *s, unsigned n);
+extern unsigned li_text(const char *s, unsigned n);
+extern unsigned long li_get(struct lrd *r, int width);
+extern long li_getlong(struct lrd *r);
+extern void li_getbytes(struct lrd *r, char *s, unsigned n);
+extern void li_gettext(unsigned off, unsigned n, struct lrd *r);
+extern void li_onmap(int x, int y);
+extern void limg_save(int fd, unsigned char lev);
+extern unsigned limg_len(const char *hd);
+extern void limg_load(const char *p, unsigned len, int pid, xchar lev);
+extern boolean limg_file(int fd);
+extern int levimg_legacy;
 
 /* MISSING FUNCTION PROTOTYPES - Essential for linking (non-conflicting only) */
 extern int cansee(int x, int y);
@@ -230,10 +327,13 @@ extern struct wseg *wsegs[32];
 extern void error(const char *s, ...);
 extern void initoptions(void);
 extern void prscore(int argc, char **argv);
+extern void rec_export(void);
 extern void gettty(void);
+extern boolean tty_crmod(void);
 /* MODERN: CONST-CORRECTNESS: settty message is read-only */
 extern void settty(const char *s);
 extern void setrandom(void);
+extern unsigned newseed(void);
 extern void startup(void);
 extern void cls(void);
 extern void gethdate(char *name);
@@ -384,11 +484,24 @@ extern coord *gettrack(int x, int y);
 extern void movemon(void);
 extern struct monst *makemon(struct permonst *ptr, int x, int y);
 extern void monfree(struct monst *mtmp);
+extern void link_monster(struct monst *mtmp);
+extern void mon_link(struct monst **head, struct monst *mtmp),
+    mon_after(struct monst *pred, struct monst *mtmp),
+    mon_head(struct monst **head);
+extern boolean mon_unlink(struct monst **head, struct monst *mtmp);
+extern void monq_reset(void);
+extern void prmonqstats(void);
 extern void rloc(struct monst *mtmp);
 extern coord enexto(xchar xx, xchar yy);
 extern void glibr(void);
 extern void hack_timeout(void);
 extern void stoned_dialogue(void);
+extern void timer_at(long when, void (*fn)(int arg), int arg);
+extern void run_timers(void);
+extern long utimeout(int prop);
+extern void set_utimeout(int prop, long n);
+extern void incr_utimeout(int prop, long n);
+extern void utimeouts_restored(void);
 /* MODERN: CONST-CORRECTNESS: death reason string is read-only */
 extern void done(const char *how);
 
@@ -499,6 +612,19 @@ extern void del_engr(struct engr *ep);
 extern void cleanup_all_engravings(void);
 extern void bwrite(int fd, char *loc, unsigned num);
 extern void mread(int fd, char *buf, unsigned len);
+extern void bufon(int fd);
+extern int bufoff(int fd);
+extern void mbufon(int fd);
+extern void mbufoff(int fd);
+extern void prlevstats(void);
+extern long levcache_kb;
+extern int cache_level(int lev);
+extern int uncache_level(int lev);
+extern int savelevimg(int fd, int lev);
+extern void restlevfiles(int fd);
+extern void pregen_idle(void);
+extern int pregen_take(int lev);
+extern boolean hasbones(int lev);
 extern int mhitu(struct monst *mtmp);
 extern int hitu(struct monst *mtmp, int dam);
 
@@ -509,6 +635,17 @@ extern void savetrapchn(int fd, struct trap *trap);
 extern void saveobjchn(int fd, struct obj *otmp);
 extern void save_engravings(int fd);
 extern void rest_engravings(int fd);
+extern struct engr *stash_engravings(void);
+extern void unstash_engravings(struct engr *ep, boolean reorder);
+extern void engr_image(struct limg *rec);
+extern void engr_unimage(struct lrd *rec);
+extern unsigned egd_size(void);
+extern void egd_image(struct limg *w, struct monst *mtmp);
+extern void egd_unimage(struct lrd *r, struct monst *mtmp);
+extern void lev_regen(long omoves);
+extern void free_engravings(struct engr *ep);
+extern void date_engravings(long dmoves);
+extern unsigned long engravings_size(struct engr *ep);
 extern int getbones(void);
 extern void makelevel(void);
 extern void setgd(void);
@@ -632,6 +769,7 @@ struct you {
 };
 
 extern struct you u;
+extern void utimeout_counts(struct prop *uprops); /* hack.timeout.c */
 
 /* MODERN: CONST-CORRECTNESS: match traps[] definition (read-only string table)
  */
@@ -649,6 +787,11 @@ extern void useup(struct obj *obj), freeinv(struct obj *obj),
     delobj(struct obj *obj), freeobj(struct obj *obj);
 extern void freegold(struct gold *gold), deltrap(struct trap *trap),
     stackobj(struct obj *obj);
+extern void obj_link(struct obj **head, struct obj *obj),
+    obj_after(struct obj *pred, struct obj *obj),
+    obj_head(struct obj **head); /* MODERN: back-linked chains */
+extern boolean obj_unlink(struct obj **head, struct obj *obj);
+extern void gold_link(struct gold *gold), trap_link(struct trap *trap);
 extern void prinv(struct obj *obj), doinv(char *lets);
 extern int ddoinv(), dotypeinv(), dolook();
 extern int merged(struct obj *otmp, struct obj *obj, int lose), countgold(),
@@ -666,6 +809,35 @@ extern struct monst *m_at(int x, int y);
 extern struct trap *t_at(int x, int y);
 extern struct gold *g_at(int x, int y);
 extern struct wseg *m_atseg;
+
+/* OCCUPANCY GRID PROTOTYPES - hack.grid.c */
+struct wseg;
+extern struct monst *mon_grid_at(int x, int y, struct wseg **segp);
+extern void place_monster(struct monst *mtmp, int x, int y);
+extern void remove_monster(struct monst *mtmp);
+extern void place_wseg(struct wseg *wtmp, struct monst *mtmp);
+extern void remove_wseg(struct wseg *wtmp);
+extern void place_worm(struct monst *mtmp);
+extern struct obj *obj_grid_at(int x, int y);
+extern struct obj *sobj_grid_at(int n, int x, int y);
+extern void order_object(struct obj *obj);
+extern void place_object(struct obj *obj, int x, int y);
+extern void remove_object(struct obj *obj);
+extern struct gold *gold_grid_at(int x, int y);
+extern void place_gold(struct gold *gold, int x, int y);
+extern void remove_gold(struct gold *gold);
+extern struct trap *trap_grid_at(int x, int y);
+extern void place_trap(struct trap *trap);
+extern void remove_trap(struct trap *trap);
+extern void clear_grid(void);
+extern void rebuild_grid(void);
+
+/* ID INDEX PROTOTYPES - hack.ident.c */
+extern void id_obj(struct obj *obj), id_mon(struct monst *mtmp);
+extern void id_drop(void *ent), id_forget(unsigned id, void *ent);
+extern struct obj *obj_by_id(unsigned id);
+extern struct monst *mon_by_id(unsigned id);
+extern void id_level(boolean on);
 extern void setnotworn(struct obj *obj),
     obfree(struct obj *obj, struct obj *other), unpobj(struct obj *obj);
 /* MODERN: CONST-CORRECTNESS: cornline text is read-only */
@@ -0,0 +1,196 @@
+/* hack.ident.c - Identifier index for objects and monsters
+ *
+ * MODERN ADDITION (2026): Answers "which object has o_id n" and "which
+ * monster has m_id n" without walking the entity chains.
+ *
+ * WHY: The shopkeeper keeps its bill as a list of o_ids, and bp_to_obj()
+ * found each one by walking invent, fobj, fcobj, billobjs and the
+ * inventory of every monster on the level - once per bill entry, so
+ * listing or paying a long bill on a crowded level was quadratic.
+ * dorecover() found u.ustuck by walking fmon for its m_id.
+ *
+ * HOW: Two open-addressing tables, one per kind, map an id to the entity
+ * carrying it. obj_link() and mon_link() file whatever goes into a chain,
+ * the chain restorers file what they read, and lfree() takes a block out
+ * of the index when it dies: its chain header remembers the id it was
+ * filed under (lgetid()), so a stale entry never outlives its entity even
+ * if the id field was changed meanwhile. A level moved into the level
+ * cache is taken out with id_level(FALSE) and filed again when it comes
+ * back, so the index holds exactly what the chain walks could reach: the
+ * current level, the hero's inventory and ice box, and monsters in transit.
+ *
+ * PRESERVES: The structs and save files are unchanged; ids are assigned
+ * as before and the chains stay the authority for saving and iteration.
+ * A lookup checks that the entity still carries the id, so an entity whose
+ * id was rewritten (bones) is not found under the old one.
+ * ADDS: O(1) obj_by_id() and mon_by_id().
+ */
+
+#include "hack.h"
+
+extern struct obj *billobjs;
+
+struct ident { /* a slot; ent == 0 if it is free */
+  unsigned id;
+  void *ent;
+};
+
+struct idtab {
+  struct ident *slot;
+  unsigned mask; /* slots - 1, a power of two less one; 0 if none yet */
+  unsigned used;
+};
+
+static struct idtab objids, monids;
+
+/* ids come from one counter, so the low bits spread them evenly */
+#define home(t, id) ((id) & (t)->mask)
+
+static void id_grow(struct idtab *t) {
+  struct ident *old = t->slot;
+  unsigned i, n = t->mask ? t->mask + 1 : 0, j;
+
+  t->mask = n ? 2 * n - 1 : 255;
+  t->slot = (struct ident *)alloc((t->mask + 1) * sizeof(struct ident));
+  (void)memset((char *)t->slot, 0, (t->mask + 1) * sizeof(struct ident));
+  for (i = 0; i < n; i++)
+    if (old[i].ent) {
+      for (j = home(t, old[i].id); t->slot[j].ent; j = (j + 1) & t->mask)
+        ;
+      t->slot[j] = old[i];
+    }
+  if (old)
+    free((char *)old);
+}
+
+/*
+ * An id may be filed twice for a while: do_oname() copies an object before
+ * the original goes, dorecover() reads the current level twice, and mklev()
+ * for a pregenerated level hands out ids the hero's inventory already has
+ * until pregen_take() renumbers them. Each entry leaves with its own entity.
+ */
+static void id_put(struct idtab *t, unsigned id, void *ent) {
+  unsigned i;
+
+  if (2 * (t->used + 1) > t->mask + 1)
+    id_grow(t);
+  for (i = home(t, id); t->slot[i].ent; i = (i + 1) & t->mask)
+    ;
+  t->slot[i].id = id;
+  t->slot[i].ent = ent;
+  t->used++;
+}
+
+/* the next entity filed under id, starting the probe at *i */
+static void *id_get(struct idtab *t, unsigned id, unsigned *i) {
+  void *ent;
+
+  if (!t->mask)
+    return (0);
+  while ((ent = t->slot[*i].ent)) {
+    *i = (*i + 1) & t->mask;
+    if (t->slot[(*i - 1) & t->mask].id == id)
+      return (ent);
+  }
+  return (0);
+}
+
+/* take ent out from under id; the slots after it move up to keep probing */
+static boolean id_del(struct idtab *t, unsigned id, void *ent) {
+  unsigned i, j, k;
+
+  if (!t->mask)
+    return (FALSE);
+  for (i = home(t, id); t->slot[i].id != id || t->slot[i].ent != ent;
+       i = (i + 1) & t->mask)
+    if (!t->slot[i].ent)
+      return (FALSE);
+  t->slot[i].ent = 0;
+  t->used--;
+  for (j = (i + 1) & t->mask; t->slot[j].ent; j = (j + 1) & t->mask) {
+    k = home(t, t->slot[j].id);
+    if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+      continue; /* still reachable from its home */
+    t->slot[i] = t->slot[j];
+    t->slot[j].ent = 0;
+    i = j;
+  }
+  return (TRUE);
+}
+
+/* ent from lalloc() is dying, or leaving the index; it was filed under id */
+void id_forget(unsigned id, void *ent) {
+  if (!id_del(&objids, id, ent))
+    (void)id_del(&monids, id, ent);
+}
+
+static void id_file(struct idtab *t, unsigned id, void *ent) {
+  unsigned old = lgetid(ent);
+
+  if (old == id)
+    return;
+  if (old)
+    id_forget(old, ent);
+  lsetid(ent, id);
+  if (id)
+    id_put(t, id, ent);
+}
+
+void id_obj(struct obj *obj) { id_file(&objids, obj->o_id, (void *)obj); }
+
+void id_mon(struct monst *mtmp) {
+  id_file(&monids, mtmp->m_id, (void *)mtmp);
+}
+
+/* take ent out of the index without freeing it */
+void id_drop(void *ent) {
+  unsigned id = lgetid(ent);
+
+  if (id) {
+    id_forget(id, ent);
+    lsetid(ent, 0);
+  }
+}
+
+struct obj *obj_by_id(unsigned id) {
+  struct obj *obj;
+  unsigned i = home(&objids, id);
+
+  while ((obj = (struct obj *)id_get(&objids, id, &i)))
+    if (obj->o_id == id)
+      return (obj);
+  return ((struct obj *)0);
+}
+
+struct monst *mon_by_id(unsigned id) {
+  struct monst *mtmp;
+  unsigned i = home(&monids, id);
+
+  while ((mtmp = (struct monst *)id_get(&monids, id, &i)))
+    if (mtmp->m_id == id)
+      return (mtmp);
+  return ((struct monst *)0);
+}
+
+static void id_objchn(struct obj *otmp, boolean on) {
+  for (; otmp; otmp = otmp->nobj)
+    if (on)
+      id_obj(otmp);
+    else
+      id_drop((void *)otmp);
+}
+
+/* file the current level's entities (on) or take them out (!on) */
+void id_level(boolean on) {
+  struct monst *mtmp;
+
+  for (mtmp = fmon; mtmp; mtmp = mtmp->nmon) {
+    if (on)
+      id_mon(mtmp);
+    else
+      id_drop((void *)mtmp);
+    id_objchn(mtmp->minvent, on);
+  }
+  id_objchn(fobj, on);
+  id_objchn(billobjs, on);
+}
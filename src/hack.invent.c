@@ -59,6 +59,93 @@ struct obj *otmp;
   return 0;
 }
 
+/*
+ * MODERN ADDITION (2026): Back-linked entity chains
+ *
+ * WHY: freeobj(), freeinv(), freegold(), deltrap() and relmon() walked
+ * their chain from the head to find the link pointing at the entity, so
+ * picking up a pile, killing a monster or springing a trap cost the length
+ * of the chain - on a level with hundreds of objects, every time.
+ *
+ * HOW: Each object, monster, gold pile and trap comes from
+ * lalloc_chained(), which keeps two more pointers in front of it: LBACK(),
+ * the address of the link that points at it - a chain head such as &fobj
+ * or &invent, or the nobj (nmon, ngold, ntrap) of the entity before it -
+ * and LHEAD(), the head of the chain it is in. obj_link() and obj_after()
+ * (mon_link(), gold_link(), trap_link()) put an entity in and set the
+ * back-links of it and of its successor; the unlink functions check that
+ * the entity belongs to the chain they were asked about and that its link
+ * still points at it, and take it out in O(1). Code that builds or moves
+ * whole chains claims them with obj_head() (mon_head()).
+ *
+ * PRESERVES: The structs, and so the save files, are unchanged: chains are
+ * the same singly linked lists in the same order. freeinv() of an object
+ * that is not in the inventory still panics instead of taking it out of
+ * another chain. A back-link that was not kept up - a chain spliced by hand
+ * instead of through these functions - is a bug: the unlink reports it
+ * with impossible() and leaves the chain alone rather than walk it.
+ * ADDS: O(1) unlinking from fobj, invent, fcobj, minvent, billobjs, fgold,
+ * ftrap and fmon.
+ */
+static void obj_put(struct obj **head, struct obj **link, struct obj *obj) {
+  if ((obj->nobj = *link))
+    LBACK(obj->nobj) = (void *)&obj->nobj;
+  LHEAD(obj) = (void *)head;
+  LBACK(obj) = (void *)link;
+  *link = obj;
+  id_obj(obj); /* see hack.ident.c */
+  if (head == &fobj)
+    order_object(obj); /* see hack.grid.c */
+}
+
+/* put obj first in the chain starting at *head */
+void obj_link(struct obj **head, struct obj *obj) { obj_put(head, head, obj); }
+
+/* put obj right after pred, in pred's chain */
+void obj_after(struct obj *pred, struct obj *obj) {
+  obj_put((struct obj **)LHEAD(pred), &pred->nobj, obj);
+}
+
+/* the chain starting at *head was built or moved by hand: claim it */
+void obj_head(struct obj **head) {
+  struct obj **link;
+
+  for (link = head; *link; link = &(*link)->nobj) {
+    LHEAD(*link) = (void *)head;
+    LBACK(*link) = (void *)link;
+  }
+}
+
+/* take obj out of the chain starting at *head; FALSE if it is not there */
+boolean obj_unlink(struct obj **head, struct obj *obj) {
+  struct obj **link = (struct obj **)LBACK(obj);
+
+  if (LHEAD(obj) != (void *)head) /* in another chain, or in none */
+    return (FALSE);
+  if (!link || *link != obj) {
+    impossible("obj_unlink: stale back-link", 0, 0);
+    return (FALSE);
+  }
+  if ((*link = obj->nobj))
+    LBACK(obj->nobj) = (void *)link;
+  LHEAD(obj) = LBACK(obj) = 0;
+  return (TRUE);
+}
+
+void gold_link(struct gold *gold) {
+  if ((gold->ngold = fgold))
+    LBACK(fgold) = (void *)&gold->ngold;
+  LHEAD(gold) = LBACK(gold) = (void *)&fgold;
+  fgold = gold;
+}
+
+void trap_link(struct trap *trap) {
+  if ((trap->ntrap = ftrap))
+    LBACK(ftrap) = (void *)&trap->ntrap;
+  LHEAD(trap) = LBACK(trap) = (void *)&ftrap;
+  ftrap = trap;
+}
+
 struct obj *addinv(obj)
 struct obj *obj;
 {
@@ -66,18 +153,17 @@ struct obj *obj;
 
   /* merge or attach to end of chain */
   if (!invent) {
-    invent = obj;
+    obj_link(&invent, obj);
     otmp = 0;
   } else
     for (otmp = invent; /* otmp */; otmp = otmp->nobj) {
       if (merged(otmp, obj, 0))
         return (otmp);
       if (!otmp->nobj) {
-        otmp->nobj = obj;
+        obj_after(otmp, obj);
         break;
       }
     }
-  obj->nobj = 0;
 
   if (flags.invlet_constant) {
     assigninvlet(obj);
@@ -87,15 +173,13 @@ struct obj *obj;
      * historical one, change the code below.
      */
     if (otmp) { /* find proper place in chain */
-      otmp->nobj = 0;
-      if ((invent->invlet ^ 040) > (obj->invlet ^ 040)) {
-        obj->nobj = invent;
-        invent = obj;
-      } else
+      (void)obj_unlink(&invent, obj);
+      if ((invent->invlet ^ 040) > (obj->invlet ^ 040))
+        obj_link(&invent, obj);
+      else
         for (otmp = invent;; otmp = otmp->nobj) {
           if (!otmp->nobj || (otmp->nobj->invlet ^ 040) > (obj->invlet ^ 040)) {
-            obj->nobj = otmp->nobj;
-            otmp->nobj = obj;
+            obj_after(otmp, obj);
             break;
           }
         }
@@ -119,16 +203,8 @@ void useup(obj) struct obj *obj;
 
 void freeinv(obj) struct obj *obj;
 {
-  struct obj *otmp;
-
-  if (obj == invent)
-    invent = invent->nobj;
-  else {
-    for (otmp = invent; otmp->nobj != obj; otmp = otmp->nobj)
-      if (!otmp->nobj)
-        panic("freeinv");
-    otmp->nobj = obj->nobj;
-  }
+  if (!obj_unlink(&invent, obj)) /* MODERN: O(1), see obj_link() */
+    panic("freeinv");
 }
 
 /* destroy object in fobj chain (if unpaid, it remains on the bill) */
@@ -142,50 +218,53 @@ void delobj(obj) struct obj *obj;
 /* unlink obj from chain starting with fobj */
 void freeobj(obj) struct obj *obj;
 {
-  struct obj *otmp;
-
-  if (obj == fobj)
-    fobj = fobj->nobj;
-  else {
-    for (otmp = fobj; otmp->nobj != obj; otmp = otmp->nobj)
-      if (!otmp)
-        panic("error in freeobj");
-    otmp->nobj = obj->nobj;
-  }
+  if (!obj_unlink(&fobj, obj)) /* MODERN: O(1), see obj_link() */
+    panic("error in freeobj");
+  remove_object(obj); /* MODERN: occupancy grid, see hack.grid.c */
 }
 
 /* Note: freegold throws away its argument! */
 void freegold(gold) struct gold *gold;
 {
-  struct gold *gtmp;
+  struct gold **link = (struct gold **)LBACK(gold);
 
-  if (gold == fgold)
-    fgold = gold->ngold;
-  else {
-    for (gtmp = fgold; gtmp->ngold != gold; gtmp = gtmp->ngold)
-      if (!gtmp)
-        panic("error in freegold");
-    gtmp->ngold = gold->ngold;
+  /* MODERN: O(1), see obj_link() */
+  if (LHEAD(gold) != (void *)&fgold)
+    panic("error in freegold");
+  if (!link || *link != gold) {
+    impossible("freegold: stale back-link", 0, 0);
+    return;
   }
-  free((char *)gold);
+  if ((*link = gold->ngold))
+    LBACK(gold->ngold) = (void *)link;
+  remove_gold(gold); /* MODERN: occupancy grid */
+  lfree((char *)gold);
 }
 
 void deltrap(trap) struct trap *trap;
 {
-  struct trap *ttmp;
+  struct trap **link = (struct trap **)LBACK(trap);
 
-  if (trap == ftrap)
-    ftrap = ftrap->ntrap;
-  else {
-    for (ttmp = ftrap; ttmp->ntrap != trap; ttmp = ttmp->ntrap)
-      ;
-    ttmp->ntrap = trap->ntrap;
+  /* MODERN: O(1), see obj_link() */
+  if (LHEAD(trap) != (void *)&ftrap || !link || *link != trap) {
+    impossible("deltrap: stale back-link", 0, 0);
+    return;
   }
-  free((char *)trap);
+  if ((*link = trap->ntrap))
+    LBACK(trap->ntrap) = (void *)link;
+  remove_trap(trap); /* MODERN: occupancy grid */
+  lfree((char *)trap);
 }
 
 struct wseg *m_atseg;
 
+struct monst *m_at(int x, int y) {
+  /* MODERN: one lookup in the occupancy grid, see hack.grid.c */
+  return (mon_grid_at(x, y, &m_atseg));
+}
+
+#if 0
+/* ORIGINAL 1984 CODE - preserved for reference */
 struct monst *m_at(int x, int y) {
   struct monst *mtmp;
 #ifndef NOWORM
@@ -208,7 +287,20 @@ struct monst *m_at(int x, int y) {
   }
   return (0);
 }
+#endif /* 0 */
 
+struct obj *o_at(int x, int y) {
+  /* MODERN: the first object of the square, see hack.grid.c */
+  return (obj_grid_at(x, y));
+}
+
+struct obj *sobj_at(int n, int x, int y) {
+  /* MODERN: walks only the objects on the square */
+  return (sobj_grid_at(n, x, y));
+}
+
+#if 0
+/* ORIGINAL 1984 CODE - preserved for reference */
 struct obj *o_at(x, y)
 int x, y;
 {
@@ -230,6 +322,7 @@ int n, x, y;
       return (otmp);
   return (0);
 }
+#endif /* 0 */
 
 int carried(obj)
 struct obj *obj;
@@ -264,6 +357,18 @@ struct obj *objchn;
   return ((struct obj *)0);
 }
 
+struct trap *t_at(int x, int y) {
+  /* MODERN: one lookup in the occupancy grid, see hack.grid.c */
+  return (trap_grid_at(x, y));
+}
+
+struct gold *g_at(int x, int y) {
+  /* MODERN: one lookup in the occupancy grid */
+  return (gold_grid_at(x, y));
+}
+
+#if 0
+/* ORIGINAL 1984 CODE - preserved for reference */
 struct trap *t_at(x, y)
 int x, y;
 {
@@ -287,6 +392,7 @@ int x, y;
   }
   return (0);
 }
+#endif /* 0 */
 
 /* make dummy object structure containing gold - for temporary use only */
 struct obj *mkgoldobj(q)
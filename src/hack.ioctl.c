@@ -105,7 +105,7 @@ void setioctls(void) {
 #ifdef SUSPEND /* implies BSD */
 int dosuspend(void) {
 #ifdef SIGTSTP
-  if (signal(SIGTSTP, SIG_IGN) == SIG_DFL) {
+  if (!headless && signal(SIGTSTP, SIG_IGN) == SIG_DFL) {
     settty((char *)0);
     (void)signal(SIGTSTP, SIG_DFL);
     (void)kill(0, SIGTSTP);
@@ -0,0 +1,280 @@
+/* hack.journal.c - Record and replay of complete games
+ *
+ * MODERN ADDITION (2026): 'hack -j<file>' keeps a journal of a game,
+ * 'hack -r<file>' plays the journal back without a terminal.
+ *
+ * WHY: The seed comes from arc4random or getentropy (see setrandom()) and
+ * nothing the player typed is kept, so a game that crashed or misbehaved
+ * cannot be played again. Scripted headless games need a fixed workload.
+ *
+ * HOW: jr_start(), called where a new game begins, draws a seed, reseeds
+ * the random streams with it and writes the journal header: seed, screen
+ * size, player name, character, the option flags and (wizard mode) the
+ * genocide lists.
+ * After that every input the game depends on is appended as an event of
+ * one type byte and a 32-bit value, written through at once so that the
+ * journal of a crashed game is complete:
+ *	K	a keystroke from jr_getchar() (EOF included)
+ *	H	a hash of the shadow screen, every JR_CHECK keystrokes
+ *	M N O Y	phase_of_the_moon(), night(), midnight(), getyear()
+ *	I	an interrupt (^C) from the terminal
+ *	W	a new terminal size after SIGWINCH
+ * A replay reads the header at startup, runs headless with the recorded
+ * screen size, replaces the same values in the same order, and compares
+ * each H with its own screen. The first mismatch stops the replay with the
+ * keystroke number. A replay uses its own lock and save file names and
+ * does not enter the score list.
+ *
+ * A restored game has no journal - its past is in the save file, not in the
+ * keystrokes. Journaled games neither find nor leave bones, which depend on
+ * files other games wrote.
+ *
+ * PRESERVES: Games without -j or -r read the terminal and the clock as
+ * before.
+ * ADDS: Reproducible games for bug reports and a realistic benchmark load.
+ */
+
+#include "hack.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define JR_MAGIC 0x524a4831 /* "RJH1" */
+#define JR_CHECK 16         /* keystrokes between screen hashes */
+#define JR_EVSZ 5           /* type byte + 32-bit value */
+
+extern char plname[PL_NSIZ], pl_character[];
+extern char genocided[60], fut_geno[60];
+extern char SAVEF[];
+extern int CO, LI;
+extern void done1(int sig);
+extern void clearlocks(void);
+
+/* Head of a journal, followed by the events */
+struct jrhdr {
+  unsigned magic;
+  unsigned flagsz; /* sizeof(struct flag) of the writer */
+  unsigned seed;
+  int co, li;
+  char name[PL_NSIZ];
+  char pl_char[PL_CSIZ];
+  char geno[60], fgeno[60];
+  struct flag flags;
+};
+
+int jr_mode; /* JR_OFF, JR_RECORD or JR_REPLAY */
+
+static int jr_fd = -1;
+static boolean jr_on;          /* header written or applied */
+static struct jrhdr jr_hdr;
+static unsigned char *jr_buf;  /* replay: the events */
+static long jr_len, jr_pos;
+static long jr_keys, jr_checks;
+
+static void jr_put(int type, unsigned val) {
+  unsigned char ev[JR_EVSZ];
+
+  ev[0] = (unsigned char)type;
+  ev[1] = (unsigned char)(val & 0xff);
+  ev[2] = (unsigned char)((val >> 8) & 0xff);
+  ev[3] = (unsigned char)((val >> 16) & 0xff);
+  ev[4] = (unsigned char)((val >> 24) & 0xff);
+  if (write(jr_fd, ev, JR_EVSZ) != JR_EVSZ) {
+    (void)close(jr_fd);
+    jr_fd = -1;
+    jr_on = FALSE;
+    pline("Cannot write the journal; it stops here.");
+  }
+}
+
+/* type of the next replay event; 0 at the end of the journal */
+static int jr_peek(void) {
+  return (jr_pos + JR_EVSZ <= jr_len) ? jr_buf[jr_pos] : 0;
+}
+
+static unsigned jr_take(void) {
+  unsigned char *ev = jr_buf + jr_pos;
+
+  jr_pos += JR_EVSZ;
+  return ev[1] | (ev[2] << 8) | ((unsigned)ev[3] << 16) |
+         ((unsigned)ev[4] << 24);
+}
+
+static void jr_diverged(const char *what) {
+  settty((char *)0);
+  fprintf(stderr, "Replay diverged at keystroke %ld: %s.\n", jr_keys, what);
+  clearlocks();
+  exit(1);
+}
+
+/* the next event must be of this type */
+static unsigned jr_expect(int type) {
+  char buf[64];
+
+  if (jr_peek() != type) {
+    (void)snprintf(buf, sizeof(buf), "game wants '%c', journal has '%c'", type,
+            jr_peek() ? jr_peek() : '-');
+    jr_diverged(buf);
+  }
+  return jr_take();
+}
+
+static void jr_summary(void) {
+  fprintf(stderr, "Replay: %ld keystrokes, %ld screen checks matched", jr_keys,
+          jr_checks);
+  if (jr_pos < jr_len)
+    fprintf(stderr, ", %ld events left over", (jr_len - jr_pos) / JR_EVSZ);
+  fprintf(stderr, ".\n");
+  (void)unlink(SAVEF);
+  free(jr_buf);
+}
+
+/* from main(), before the terminal is set up */
+void jr_open(const char *file, int mode) {
+  long n;
+
+  jr_mode = mode;
+  if (mode == JR_RECORD) {
+    if ((jr_fd = open(file, O_WRONLY | O_CREAT | O_TRUNC, FMASK)) < 0)
+      error("Cannot create journal %s.", file);
+    return;
+  }
+  if ((jr_fd = open(file, O_RDONLY)) < 0)
+    error("Cannot read journal %s.", file);
+  if (read(jr_fd, (char *)&jr_hdr, sizeof(jr_hdr)) != sizeof(jr_hdr) ||
+      jr_hdr.magic != JR_MAGIC || jr_hdr.flagsz != sizeof(struct flag))
+    error("%s is not a journal of this version of hack.", file);
+  jr_len = lseek(jr_fd, (off_t)0, SEEK_END) - (long)sizeof(jr_hdr);
+  jr_buf = (unsigned char *)alloc((unsigned)jr_len + 1);
+  (void)lseek(jr_fd, (off_t)sizeof(jr_hdr), SEEK_SET);
+  for (jr_pos = 0; jr_pos < jr_len; jr_pos += n)
+    if ((n = read(jr_fd, jr_buf + jr_pos, (size_t)(jr_len - jr_pos))) <= 0)
+      error("Cannot read journal %s.", file);
+  (void)close(jr_fd);
+  jr_fd = -1;
+  jr_pos = 0;
+  headless = TRUE;
+  (void)strncpy(plname, jr_hdr.name, PL_NSIZ - 1);
+  wizard = jr_hdr.flags.debug; /* decides the lock, see main() */
+  (void)atexit(jr_summary);
+}
+
+/* replay: the recorded screen size, for startup() */
+void jr_termsize(int *co, int *li) {
+  if (jr_mode != JR_REPLAY)
+    return;
+  *co = jr_hdr.co;
+  *li = jr_hdr.li;
+}
+
+/* a new game begins */
+void jr_start(void) {
+  if (jr_mode == JR_RECORD && jr_fd >= 0) {
+    (void)memset((char *)&jr_hdr, 0, sizeof(jr_hdr));
+    jr_hdr.magic = JR_MAGIC;
+    jr_hdr.flagsz = sizeof(struct flag);
+    jr_hdr.seed = newseed();
+    jr_hdr.co = CO;
+    jr_hdr.li = LI;
+    (void)strncpy(jr_hdr.name, plname, PL_NSIZ - 1);
+    (void)strncpy(jr_hdr.pl_char, pl_character, PL_CSIZ - 1);
+    (void)memcpy(jr_hdr.geno, genocided, sizeof(jr_hdr.geno));
+    (void)memcpy(jr_hdr.fgeno, fut_geno, sizeof(jr_hdr.fgeno));
+    jr_hdr.flags = flags;
+    if (write(jr_fd, (char *)&jr_hdr, sizeof(jr_hdr)) != sizeof(jr_hdr))
+      error("Cannot write the journal.");
+    jr_on = TRUE;
+  } else if (jr_mode == JR_REPLAY) {
+    (void)strncpy(plname, jr_hdr.name, PL_NSIZ - 1);
+    (void)strncpy(pl_character, jr_hdr.pl_char, PL_CSIZ - 1);
+    (void)memcpy(genocided, jr_hdr.geno, sizeof(jr_hdr.geno));
+    (void)memcpy(fut_geno, jr_hdr.fgeno, sizeof(jr_hdr.fgeno));
+    flags = jr_hdr.flags;
+    jr_on = TRUE;
+  } else
+    return;
+  rnd_seed(jr_hdr.seed);
+}
+
+/* record: the save file was restored instead */
+void jr_restored(void) {
+  if (jr_mode == JR_RECORD && jr_fd >= 0) {
+    (void)close(jr_fd);
+    jr_fd = -1;
+    pline("No journal is kept of a restored game.");
+  }
+}
+
+/* getchar() for the game: recorded, or taken from the journal */
+int jr_getchar(void) {
+  int c;
+
+  if (!jr_on)
+    return (getchar());
+  if (jr_mode == JR_RECORD) {
+    if (!(jr_keys % JR_CHECK))
+      jr_put('H', scr_hash());
+    c = getchar();
+    jr_keys++;
+    if (jr_on)
+      jr_put('K', (unsigned)c);
+    return (c);
+  }
+  for (;;) {
+    switch (jr_peek()) {
+    case 'H':
+      if (jr_take() != scr_hash())
+        jr_diverged("the screen differs");
+      jr_checks++;
+      continue;
+    case 'I':
+      (void)jr_take();
+      done1(SIGINT);
+      continue;
+    case 0:
+      end_of_input();
+      /* NOTREACHED */
+    }
+    c = (int)jr_expect('K');
+    jr_keys++;
+    return (c);
+  }
+}
+
+/* a value read from the clock */
+int jr_clock(int type, int val) {
+  if (jr_on && jr_mode == JR_RECORD)
+    jr_put(type, (unsigned)val);
+  else if (jr_on && jr_mode == JR_REPLAY && jr_peek())
+    val = (int)jr_expect(type);
+  return (val);
+}
+
+/* record: ^C arrived; replay gives it back at the next keystroke */
+void jr_intr(void) {
+  if (jr_on && jr_mode == JR_RECORD)
+    jr_put('I', 0);
+}
+
+/* replay: is a terminal resize next in the journal? */
+boolean jr_resized(void) {
+  return (boolean)(jr_on && jr_mode == JR_REPLAY && jr_peek() == 'W');
+}
+
+/* after startup() re-read the terminal size */
+void jr_resize(int *co, int *li) {
+  unsigned v;
+
+  if (!jr_on)
+    return;
+  if (jr_mode == JR_RECORD) {
+    jr_put('W', ((unsigned)*co << 16) | ((unsigned)*li & 0xffff));
+  } else {
+    v = jr_expect('W');
+    *co = (int)(v >> 16);
+    *li = (int)(v & 0xffff);
+  }
+}
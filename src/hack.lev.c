@@ -12,9 +12,14 @@
 #include "hack.h"
 /* def.mkroom.h already included via hack.h */
 
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/stat.h>
 #include <unistd.h>
-extern struct monst *restmonchn();
-extern struct obj *restobjchn();
+extern void restmonchn(int fd, struct monst **head);
+extern void restobjchn(int fd, struct obj **head);
 extern struct obj *billobjs;
 extern char *itoa();
 extern char SAVEF[];
@@ -29,6 +34,7 @@ extern long wgrowtime[32];
 #endif /* NOWORM */
 
 boolean level_exists[MAXLEVEL + 1];
+int levimg_legacy; /* hack-bench: write levels the 1984 way */
 
 /* Original 1984: void savelev(int fd, xchar lev) */
 void savelev(
@@ -46,6 +52,18 @@ void savelev(
   if (lev <= MAXLEVEL)
     level_exists[lev] = TRUE;
 
+  if (!levimg_legacy) { /* MODERN: a level image, see hack.levimg.c */
+    limg_save(fd, lev);
+    billobjs = 0;
+    fgold = 0;
+    ftrap = 0;
+    fmon = 0;
+    fobj = 0;
+    monq_reset();
+    clear_grid();
+    arena_release(lev); /* MODERN: the level's entities are all gone */
+    return;
+  }
   bwrite(fd, (char *)&hackpid, sizeof(hackpid));
   bwrite(fd, (char *)&lev, sizeof(lev));
   bwrite(fd, (char *)levl, sizeof(levl));
@@ -69,6 +87,8 @@ void savelev(
   ftrap = 0;
   fmon = 0;
   fobj = 0;
+  monq_reset(); /* MODERN: the run queue pointed at the freed monsters */
+  clear_grid(); /* MODERN: the occupancy grid described this level */
 #ifndef NOWORM
   bwrite(fd, (char *)wsegs, sizeof(wsegs));
   for (tmp = 1; tmp < 32; tmp++) {
@@ -80,14 +100,746 @@ void savelev(
   }
   bwrite(fd, (char *)wgrowtime, sizeof(wgrowtime));
 #endif /* NOWORM */
+  arena_release(lev);
+}
+
+/*
+ * MODERN ADDITION (2026): Buffered level and save streams
+ *
+ * WHY: bwrite() and mread() made one write()/read() per field, and the
+ * chain savers add two more per monster, object, gold pile and trap (the
+ * length prefix and the record). A staircase cost thousands of system calls,
+ * each of which could fail halfway through with a bare "cannot write 12
+ * bytes to file #5".
+ *
+ * HOW: bufon(fd) makes bwrite() to fd collect into memory and bufoff(fd)
+ * hands it all to the kernel with one write(). mbufon(fd) pulls the rest of
+ * the file in with one read() and mread() serves from that until mbufoff().
+ * One file of each direction can be buffered at a time; other descriptors
+ * go straight to the system as before.
+ *
+ * PRESERVES: The bytes on disk are unchanged, so level, bones and save
+ * files stay compatible. A short read still ends the game (or the restore)
+ * the way it did.
+ * ADDS: One write per level file and one read per load; failures name the
+ * operation and the system's reason. #stats counts the system calls.
+ */
+static int wbuf_fd = -1, rbuf_fd = -1;
+static char *wbuf, *rbuf;
+static unsigned wbuf_len, wbuf_size, rbuf_len, rbuf_pos, rbuf_size;
+static long lev_writes, lev_reads;
+
+void bufon(int fd) {
+  if (wbuf_fd >= 0 && wbuf_fd != fd && bufoff(wbuf_fd) < 0)
+    panic("Cannot write file #%d: %s", wbuf_fd, strerror(errno));
+  wbuf_fd = fd;
+  wbuf_len = 0;
+}
+
+/* write out what bwrite() collected for fd; -1 (errno set) on failure */
+int bufoff(int fd) {
+  unsigned done = 0;
+  ssize_t n;
+
+  if (fd != wbuf_fd)
+    return (0);
+  wbuf_fd = -1;
+  while (done < wbuf_len) {
+    lev_writes++;
+    if ((n = write(fd, wbuf + done, (size_t)(wbuf_len - done))) < 0) {
+      if (errno == EINTR)
+        continue;
+      return (-1);
+    }
+    if (n == 0) {
+      errno = ENOSPC;
+      return (-1);
+    }
+    done += (unsigned)n;
+  }
+  return (0);
+}
+
+/* make room for num more bytes in the write buffer */
+static void wbuf_grow(unsigned num) {
+  if (wbuf_len + num > wbuf_size) {
+    while (wbuf_len + num > wbuf_size)
+      wbuf_size = wbuf_size ? 2 * wbuf_size : 16384;
+    wbuf = (char *)enlarge(wbuf, wbuf_size);
+  }
 }
 
 void bwrite(int fd, char *loc, unsigned num) {
+  if (fd == wbuf_fd) {
+    wbuf_grow(num);
+    (void)memcpy(wbuf + wbuf_len, loc, (size_t)num);
+    wbuf_len += num;
+    return;
+  }
+  lev_writes++;
   /* lint wants the 3rd arg of write to be an int; lint -p an unsigned */
   if (write(fd, loc, (size_t)num) != (ssize_t)num) /* MODERN: proper POSIX types */
     panic("cannot write %u bytes to file #%d", num, fd);
 }
 
+/* read the rest of fd in one go; mread() serves from memory afterwards */
+void mbufon(int fd) {
+  struct stat st;
+  off_t here;
+  ssize_t n;
+
+  mbufoff(rbuf_fd);
+  if (fstat(fd, &st) < 0 || (here = lseek(fd, (off_t)0, SEEK_CUR)) < 0 ||
+      st.st_size < here)
+    return; /* not a plain file: leave it unbuffered */
+  if ((unsigned)(st.st_size - here) > rbuf_size) {
+    rbuf_size = (unsigned)(st.st_size - here);
+    rbuf = (char *)enlarge(rbuf, rbuf_size ? rbuf_size : 1);
+  }
+  rbuf_len = rbuf_pos = 0;
+  while (rbuf_len < (unsigned)(st.st_size - here)) {
+    lev_reads++;
+    if ((n = read(fd, rbuf + rbuf_len,
+                  (size_t)(st.st_size - here) - rbuf_len)) < 0) {
+      if (errno == EINTR)
+        continue;
+      break; /* mread() reports the shortfall */
+    }
+    if (n == 0)
+      break;
+    rbuf_len += (unsigned)n;
+  }
+  rbuf_fd = fd;
+}
+
+/* stop serving fd from memory; its offset goes back to what was consumed */
+void mbufoff(int fd) {
+  if (fd < 0 || fd != rbuf_fd)
+    return;
+  rbuf_fd = -1;
+  if (rbuf_pos < rbuf_len)
+    (void)lseek(fd, -(off_t)(rbuf_len - rbuf_pos), SEEK_CUR);
+}
+
+#ifdef HACK_BENCH
+long levio_calls(void) { return (lev_writes + lev_reads); }
+#endif /* HACK_BENCH */
+
+/* regenerate animals while on another level */
+void lev_regen(long omoves) {
+  long tmoves = (moves > omoves) ? moves - omoves : 0;
+  struct monst *mtmp, *mtmp2;
+  extern char genocided[];
+
+  for (mtmp = fmon; mtmp; mtmp = mtmp2) {
+    long newhp; /* tmoves may be very large */
+
+    mtmp2 = mtmp->nmon;
+    if (index(genocided, mtmp->data->mlet)) {
+      mondead(mtmp);
+      continue;
+    }
+
+    if (mtmp->mtame && tmoves > 250) {
+      mtmp->mtame = 0;
+      mtmp->mpeaceful = 0;
+    }
+
+    newhp =
+        mtmp->mhp + (index(MREGEN, mtmp->data->mlet) ? tmoves : tmoves / 20);
+    if (newhp > mtmp->mhpmax)
+      mtmp->mhp = mtmp->mhpmax;
+    else
+      mtmp->mhp = (schar)newhp; /* MODERN: cast to schar */
+  }
+}
+
+/*
+ * MODERN ADDITION (2026): Resident level cache
+ *
+ * WHY: Every staircase wrote the level being left to its file and read the
+ * one being entered back, though the player mostly walks between the same
+ * few levels and the whole dungeon fits in a few hundred kilobytes.
+ *
+ * HOW: goto_level() hands the level to cache_level(), which moves its
+ * chains and arrays into a struct levcache instead of writing them out.
+ * uncache_level() puts them back the way getlev() would, including the
+ * regeneration of monsters and the order the file round trip leaves gold,
+ * traps and engravings in. When the cached levels outgrow levcache_kb
+ * (HACKOPTIONS levelcache:<KB>, 0 turns the cache off) the least recently
+ * left ones are written to their level files with savelev() as before.
+ *
+ * PRESERVES: Level files, bones and save files are unchanged; dosave0()
+ * takes cached levels straight from memory. A level that cannot be spilled
+ * stays in memory rather than being lost.
+ * ADDS: Stair changes without file I/O; #stats shows hits, spills and the
+ * memory held.
+ */
+struct levcache {
+  struct levcache *nlev; /* most recently left first */
+  int lev;
+  unsigned long size;
+  long omoves;
+  struct rm levl[COLNO][ROWNO];
+  unsigned char xupstair, yupstair, xdnstair, ydnstair;
+  struct monst *fmon;
+  struct gold *fgold;
+  struct trap *ftrap;
+  struct obj *fobj, *billobjs;
+  struct engr *engr;
+#ifndef QUEST
+  struct mkroom rooms[MAXNROFROOMS + 1];
+  coord doors[DOORMAX];
+#endif /* QUEST */
+#ifndef NOWORM
+  struct wseg *wsegs[32], *wheads[32];
+  long wgrowtime[32];
+#endif /* NOWORM */
+};
+
+long levcache_kb = LEVCACHE_KB;
+static struct levcache *levcache;
+static unsigned long levcache_used;
+static long levcache_hits, levcache_spills;
+
+static unsigned long objchn_size(struct obj *otmp) {
+  unsigned long size = 0;
+
+  for (; otmp; otmp = otmp->nobj)
+    size += sizeof(struct obj) + otmp->onamelth;
+  return (size);
+}
+
+static unsigned long lc_size(struct levcache *lc) {
+  unsigned long size = sizeof(struct levcache);
+  struct monst *mtmp;
+  struct gold *gold;
+  struct trap *trap;
+#ifndef NOWORM
+  struct wseg *wtmp;
+  int tmp;
+#endif /* NOWORM */
+
+  for (mtmp = lc->fmon; mtmp; mtmp = mtmp->nmon)
+    size += sizeof(struct monst) + mtmp->mxlth + mtmp->mnamelth +
+            objchn_size(mtmp->minvent);
+  for (gold = lc->fgold; gold; gold = gold->ngold)
+    size += sizeof(struct gold);
+  for (trap = lc->ftrap; trap; trap = trap->ntrap)
+    size += sizeof(struct trap);
+  size += objchn_size(lc->fobj) + objchn_size(lc->billobjs);
+  size += engravings_size(lc->engr);
+#ifndef NOWORM
+  for (tmp = 1; tmp < 32; tmp++)
+    for (wtmp = lc->wsegs[tmp]; wtmp; wtmp = wtmp->nseg)
+      size += sizeof(struct wseg);
+#endif /* NOWORM */
+  return (size);
+}
+
+/*
+ * Put a cached level back in the level globals. With reorder it is left
+ * as getlev() would leave it after savelev(); without, exactly as it was
+ * cached, for savelev() to write out.
+ */
+static void lc_install(struct levcache *lc, boolean reorder) {
+  struct gold *gold, *gold2;
+  struct trap *trap, *trap2;
+
+  fgold = 0;
+  ftrap = 0;
+  (void)memcpy((char *)levl, (char *)lc->levl, sizeof(levl));
+  xupstair = lc->xupstair;
+  yupstair = lc->yupstair;
+  xdnstair = lc->xdnstair;
+  ydnstair = lc->ydnstair;
+  fmon = lc->fmon;
+  if (reorder) {
+    lev_regen(lc->omoves);
+    setgd();
+    for (gold = lc->fgold; gold; gold = gold2) {
+      gold2 = gold->ngold;
+      gold_link(gold);
+    }
+    for (trap = lc->ftrap; trap; trap = trap2) {
+      trap2 = trap->ntrap;
+      trap_link(trap);
+    }
+  } else {
+    fgold = lc->fgold;
+    ftrap = lc->ftrap;
+  }
+  fobj = lc->fobj;
+  billobjs = lc->billobjs;
+  unstash_engravings(lc->engr, reorder);
+#ifndef QUEST
+  (void)memcpy((char *)rooms, (char *)lc->rooms, sizeof(rooms));
+  (void)memcpy((char *)doors, (char *)lc->doors, sizeof(doors));
+#endif /* QUEST */
+#ifndef NOWORM
+  (void)memcpy((char *)wsegs, (char *)lc->wsegs, sizeof(wsegs));
+  (void)memcpy((char *)wheads, (char *)lc->wheads, sizeof(wheads));
+  (void)memcpy((char *)wgrowtime, (char *)lc->wgrowtime, sizeof(wgrowtime));
+#endif /* NOWORM */
+}
+
+/* savelev() a cached level as it was left; the level globals must be empty */
+static void lc_write(int fd, struct levcache *lc) {
+  long savemoves = moves;
+
+  lc_install(lc, FALSE);
+  moves = lc->omoves;
+  savelev(fd, (unsigned char)lc->lev);
+  moves = savemoves;
+}
+
+/* write a cached level to its level file */
+static int lc_spill(struct levcache *lc) {
+  int fd;
+
+  glo(lc->lev);
+  if ((fd = creat(lock, FMASK)) < 0)
+    return (0);
+  bufon(fd);
+  lc_write(fd, lc);
+  if (bufoff(fd) < 0)
+    panic("Cannot write level file %s: %s", lock, strerror(errno));
+  (void)close(fd);
+  levcache_spills++;
+  return (1);
+}
+
+/* spill the least recently left levels until the rest fit in the budget */
+static void lc_trim(void) {
+  struct levcache **lcp, *lc;
+
+  while (levcache && levcache_used > (unsigned long)levcache_kb * 1024) {
+    for (lcp = &levcache; (*lcp)->nlev; lcp = &(*lcp)->nlev)
+      ;
+    lc = *lcp;
+    if (!lc_spill(lc))
+      return; /* no room on disk either: keep it */
+    *lcp = 0;
+    levcache_used -= lc->size;
+    free((char *)lc);
+  }
+}
+
+/* move the level globals into lc and leave them as savelev() does */
+static void lc_take(struct levcache *lc, int lev) {
+  lc->lev = lev;
+  lc->omoves = moves;
+  (void)memcpy((char *)lc->levl, (char *)levl, sizeof(levl));
+  lc->xupstair = xupstair;
+  lc->yupstair = yupstair;
+  lc->xdnstair = xdnstair;
+  lc->ydnstair = ydnstair;
+  lc->fmon = fmon;
+  lc->fgold = fgold;
+  lc->ftrap = ftrap;
+  lc->fobj = fobj;
+  lc->billobjs = billobjs;
+  id_level(FALSE); /* MODERN: out of the id index while it is cached */
+  lc->engr = stash_engravings();
+#ifndef QUEST
+  (void)memcpy((char *)lc->rooms, (char *)rooms, sizeof(rooms));
+  (void)memcpy((char *)lc->doors, (char *)doors, sizeof(doors));
+#endif /* QUEST */
+#ifndef NOWORM
+  (void)memcpy((char *)lc->wsegs, (char *)wsegs, sizeof(wsegs));
+  (void)memcpy((char *)lc->wheads, (char *)wheads, sizeof(wheads));
+  (void)memcpy((char *)lc->wgrowtime, (char *)wgrowtime, sizeof(wgrowtime));
+  (void)memset((char *)wsegs, 0, sizeof(wsegs));
+#endif /* NOWORM */
+  fgold = 0;
+  ftrap = 0;
+  fmon = 0;
+  fobj = 0;
+  billobjs = 0;
+  monq_reset();
+  clear_grid();
+}
+
+/* keep the current level in memory instead of a level file; 0 if not */
+int cache_level(int lev) {
+  struct levcache *lc;
+
+  if (levcache_kb <= 0 || lev <= 0 || lev > MAXLEVEL)
+    return (0);
+  lc = (struct levcache *)alloc(sizeof(struct levcache));
+  lc_take(lc, lev);
+  level_exists[lev] = TRUE;
+
+  lc->size = lc_size(lc);
+  lc->nlev = levcache;
+  levcache = lc;
+  levcache_used += lc->size;
+  lc_trim();
+  return (1);
+}
+
+/* getlev() from memory; 0 if lev is not in the cache */
+int uncache_level(int lev) {
+  struct levcache **lcp, *lc;
+
+  for (lcp = &levcache; *lcp; lcp = &(*lcp)->nlev)
+    if ((*lcp)->lev == lev)
+      break;
+  if (!(lc = *lcp))
+    return (0);
+  *lcp = lc->nlev;
+  levcache_used -= lc->size;
+  lc_install(lc, TRUE);
+  free((char *)lc);
+  rebuild_grid();
+  id_level(TRUE);
+  levcache_hits++;
+  return (1);
+}
+
+/*
+ * MODERN ADDITION (2026): The level below made while the player thinks
+ *
+ * WHY: The first descent to a level waited for mklev() on top of writing
+ * the level being left, in the same keystroke. The game spends almost all
+ * of its time waiting for that keystroke.
+ *
+ * HOW: parse() calls pregen_idle() before it reads a command. When no key
+ * is waiting and the level below has never been made, the current level
+ * is put aside as in cache_level(), mklev() makes dlevel+1 into the level
+ * globals as goto_level() would, and the result is put aside in its turn
+ * before the current level comes back. Since rnd_level() makes a level from
+ * the seed and its depth alone, the level is the one goto_level() would
+ * have made; what else mklev() changes - object and monster ids, object
+ * ages, the gem odds, whether the Amulet and the Wizard were made - is put
+ * back, and pregen_take() applies it afresh when the player arrives.
+ * A genocide, a new bones file or the Amulet being made in between throws
+ * the level away and goto_level() calls mklev() as before. A hangup
+ * meanwhile is held until the current level is back in place, so the save
+ * it makes holds that level.
+ *
+ * PRESERVES: Every level, id and roll of a game is what it was; replays
+ * and headless games never make levels ahead, and their journals match
+ * games that did.
+ * ADDS: Descending to a new level costs no generation; #stats shows how
+ * many levels were made ahead and used.
+ */
+static struct levcache *pregen; /* the level below, if made ahead */
+static unsigned pg_ident0, pg_ident1; /* flags.ident before and after */
+static long pg_moves;
+static unsigned pg_amulet0, pg_amulet1, pg_wizards0, pg_wizards1;
+static char pg_geno[60];
+static int pg_bones = -1; /* level skipped for its bones file */
+static long pregen_made, pregen_used;
+
+/* MODERN: lfree() a chain of objects, see lc_free() */
+static void objchn_free(struct obj *otmp) {
+  struct obj *otmp2;
+
+  for (; otmp; otmp = otmp2) {
+    otmp2 = otmp->nobj;
+    lfree((char *)otmp);
+  }
+}
+
+/* free everything a cached level holds, then its arena */
+static void lc_free(struct levcache *lc) {
+  struct monst *mtmp, *mtmp2;
+  struct gold *gold, *gold2;
+  struct trap *trap, *trap2;
+#ifndef NOWORM
+  struct wseg *wtmp, *wtmp2;
+  int tmp;
+#endif /* NOWORM */
+
+  for (mtmp = lc->fmon; mtmp; mtmp = mtmp2) {
+    mtmp2 = mtmp->nmon;
+    objchn_free(mtmp->minvent);
+    lfree((char *)mtmp);
+  }
+  for (gold = lc->fgold; gold; gold = gold2) {
+    gold2 = gold->ngold;
+    lfree((char *)gold);
+  }
+  for (trap = lc->ftrap; trap; trap = trap2) {
+    trap2 = trap->ntrap;
+    lfree((char *)trap);
+  }
+  objchn_free(lc->fobj);
+  objchn_free(lc->billobjs);
+  free_engravings(lc->engr);
+#ifndef NOWORM
+  for (tmp = 1; tmp < 32; tmp++)
+    for (wtmp = lc->wsegs[tmp]; wtmp; wtmp = wtmp2) {
+      wtmp2 = wtmp->nseg;
+      lfree((char *)wtmp);
+    }
+#endif /* NOWORM */
+  arena_release(lc->lev); /* nothing in it is in use now */
+}
+
+/* throw the level made ahead away */
+static void pregen_free(void) {
+  lc_free(pregen);
+  level_exists[pregen->lev] = FALSE;
+  free((char *)pregen);
+  pregen = 0;
+}
+
+void pregen_idle(void) {
+  extern char fut_geno[];
+  int lev = dlevel + 1, i;
+  xchar odlevel = dlevel;
+  struct levcache *cur;
+  struct you ou;
+  schar oprob[NROFOBJECTS];
+  struct pollfd pfd;
+  sigset_t hup, ohup;
+
+#ifdef HACK_BENCH
+  return; /* the benchmarks time goto_level() making its own levels */
+#endif /* HACK_BENCH */
+  if (headless || jr_mode == JR_REPLAY || dlevel <= 0 || lev > MAXLEVEL ||
+      level_exists[lev] || (pregen && pregen->lev == lev) || pg_bones == lev)
+    return;
+  pfd.fd = 0;
+  pfd.events = POLLIN;
+  if (poll(&pfd, 1, 0) != 0)
+    return; /* a key is waiting: answer it first */
+  if (hasbones(lev)) {
+    pg_bones = lev; /* getbones() may want it */
+    return;
+  }
+
+  /* a hangup now would save the level being made; it waits till the end */
+  (void)sigemptyset(&hup);
+  (void)sigaddset(&hup, SIGHUP);
+  (void)sigaddset(&hup, SIGTERM);
+  (void)sigaddset(&hup, SIGQUIT);
+  (void)sigprocmask(SIG_BLOCK, &hup, &ohup);
+  cur = (struct levcache *)alloc(sizeof(struct levcache));
+  lc_take(cur, dlevel);
+  if (pregen)
+    pregen_free();
+  ou = u;
+  pg_ident0 = flags.ident;
+  pg_moves = moves;
+  pg_amulet0 = flags.made_amulet;
+  pg_wizards0 = flags.no_of_wizards;
+  (void)strncpy(pg_geno, fut_geno, sizeof(pg_geno));
+  for (i = 0; i < NROFOBJECTS; i++)
+    oprob[i] = objects[i].oc_prob;
+
+  /* as goto_level() leaves things for mklev() */
+  dlevel = lev;
+  u.ux = FAR;
+  u.ustuck = 0;
+  u.uswallow = 0;
+  mklev();
+  pregen = (struct levcache *)alloc(sizeof(struct levcache));
+  lc_take(pregen, lev);
+  pg_ident1 = flags.ident;
+  pg_amulet1 = flags.made_amulet;
+  pg_wizards1 = flags.no_of_wizards;
+  pregen_made++;
+
+  for (i = 0; i < NROFOBJECTS; i++)
+    objects[i].oc_prob = oprob[i];
+  flags.no_of_wizards = pg_wizards0;
+  flags.made_amulet = pg_amulet0;
+  flags.ident = pg_ident0;
+  u = ou;
+  dlevel = odlevel;
+  lc_install(cur, FALSE);
+  free((char *)cur);
+  rebuild_grid();
+  id_level(TRUE);
+  (void)sigprocmask(SIG_SETMASK, &ohup, (sigset_t *)0);
+}
+
+/* install lev if it was made ahead and still would be; 0 if not */
+int pregen_take(int lev) {
+  extern char fut_geno[];
+  unsigned did;
+  long dmoves;
+  struct monst *mtmp;
+  struct obj *otmp;
+
+  if (!pregen || pregen->lev != lev)
+    return (0);
+  if (strncmp(pg_geno, fut_geno, sizeof(pg_geno)) ||
+      pg_amulet0 != flags.made_amulet || pg_wizards0 != flags.no_of_wizards ||
+      hasbones(lev)) {
+    pregen_free();
+    return (0);
+  }
+  lc_install(pregen, FALSE);
+  free((char *)pregen);
+  pregen = 0;
+  rebuild_grid();
+
+  /* number and date it as if mklev() had run just now */
+  did = flags.ident - pg_ident0;
+  dmoves = moves - pg_moves;
+  for (mtmp = fmon; mtmp; mtmp = mtmp->nmon) {
+    mtmp->m_id += did;
+    for (otmp = mtmp->minvent; otmp; otmp = otmp->nobj) {
+      otmp->o_id += did;
+      otmp->age += dmoves;
+    }
+  }
+  for (otmp = fobj; otmp; otmp = otmp->nobj) {
+    otmp->o_id += did;
+    otmp->age += dmoves;
+  }
+  date_engravings(dmoves);
+  flags.ident = pg_ident1 + did;
+  id_level(TRUE); /* MODERN: under the ids it has now */
+  flags.made_amulet = pg_amulet1;
+  flags.no_of_wizards = pg_wizards1;
+  oinit(); /* the gem odds makelevel() leaves */
+  pregen_used++;
+  return (1);
+}
+
+/*
+ * MODERN ADDITION (2026): Level images in the save file
+ *
+ * WHY: dosave0() ran getlev() and savelev() over every level file, building
+ * every monster and object of the dungeon only to write them straight out
+ * again, and dorecover() did the same in reverse before the game went on.
+ * Saving on hangup and resuming both took as long as the dungeon was deep.
+ *
+ * HOW: A level file already is what savelev() writes. savelevimg() appends
+ * it to the save file behind its length, read straight into the save file's
+ * write buffer; cached levels are spilled to their level files first. The
+ * level files are removed only once the save file has been renamed.
+ * dorecover() reads the current level and restlevfiles() copies the other
+ * images byte for byte into their level files, without decoding them, so
+ * the save file can go as the game resumes.
+ *
+ * PRESERVES: Level images are byte for byte what savelev() writes; monsters
+ * regenerate for the whole time they were away when the level is entered.
+ * The save file is still removed as the game resumes, so it cannot be
+ * restored twice, and only once every level is back in its level file.
+ * ADDS: Save format version 3 (length before each level); one read per level
+ * on save and one read and write per level on restore, with no decoding.
+ */
+
+/* read len bytes of fd onto the end of the write buffer; -1 if short */
+static int lev_splice(int fd, unsigned len) {
+  unsigned done = 0;
+  ssize_t n;
+
+  wbuf_grow(len);
+  while (done < len) {
+    lev_reads++;
+    if ((n = read(fd, wbuf + wbuf_len + done, (size_t)(len - done))) < 0) {
+      if (errno == EINTR)
+        continue;
+      return (-1);
+    }
+    if (n == 0)
+      return (-1);
+    done += (unsigned)n;
+  }
+  wbuf_len += len;
+  return (0);
+}
+
+/* write the level images of save file fd to their level files */
+void restlevfiles(int fd) {
+  struct stat st;
+  unsigned len;
+  off_t off;
+  int lev, nfd;
+
+  if (fstat(fd, &st) < 0)
+    st.st_size = 0;
+  while (read(fd, (char *)&lev, sizeof(lev)) == sizeof(lev)) {
+    mread(fd, (char *)&len, sizeof(len));
+    if (lev <= 0 || lev > MAXLEVEL || len < sizeof(hackpid) ||
+        (off = lseek(fd, (off_t)0, SEEK_CUR)) < 0 ||
+        off + (off_t)len > st.st_size) {
+      pline("Cannot read level %d from the save file.", lev);
+      (void)unlink(SAVEF);
+      error("Error restoring old game.");
+    }
+    glo(lev);
+    if ((nfd = creat(lock, FMASK)) < 0)
+      panic("Cannot open temp file %s!\n", lock);
+    bufon(nfd);
+    if (lev_splice(fd, len) < 0)
+      panic("Cannot read level %d from the save file", lev);
+    if (bufoff(nfd) < 0)
+      panic("Cannot write level file %s: %s", lock, strerror(errno));
+    (void)close(nfd);
+    level_exists[lev] = TRUE;
+  }
+}
+
+/* append level lev to the (buffered) save file fd; 0 if it cannot be read */
+int savelevimg(int fd, int lev) {
+  struct levcache **lcp, *lc;
+  struct stat st;
+  unsigned len = 0;
+  int lfd;
+
+  for (lcp = &levcache; *lcp; lcp = &(*lcp)->nlev)
+    if ((*lcp)->lev == lev)
+      break;
+  if ((lc = *lcp)) {
+    /* to its level file first, which stays until dosave0() has renamed the
+       save file; the write buffer goes to the level file meanwhile */
+    if (bufoff(fd) < 0 || !lc_spill(lc))
+      return (0);
+    *lcp = lc->nlev;
+    levcache_used -= lc->size;
+    free((char *)lc);
+  }
+  if (fd != wbuf_fd)
+    bufon(fd);
+  glo(lev);
+  if ((lfd = open(lock, O_RDONLY)) < 0)
+    return (0);
+  if (fstat(lfd, &st) < 0) {
+    (void)close(lfd);
+    return (0);
+  }
+  len = (unsigned)st.st_size;
+  bwrite(fd, (char *)&len, sizeof(len));
+  if (lev_splice(lfd, len) < 0) {
+    (void)close(lfd);
+    return (0);
+  }
+  (void)close(lfd);
+  return (1);
+}
+
+#ifdef HACK_BENCH
+/* forget every cached level */
+void levcache_drop(void) {
+  struct levcache *lc;
+
+  while ((lc = levcache)) {
+    levcache = lc->nlev;
+    lc_free(lc);
+    free((char *)lc);
+  }
+  levcache_used = 0;
+}
+#endif /* HACK_BENCH */
+
+void prlevstats(void) {
+  pline("Level files: %ld write calls, %ld read calls.", lev_writes,
+        lev_reads);
+  pline("Level cache: %ld hits, %ld spilled, %lu of %ld KB in use.",
+        levcache_hits, levcache_spills, (levcache_used + 1023) / 1024,
+        levcache_kb);
+  pline("Levels made ahead: %ld, %ld of them used.", pregen_made,
+        pregen_used);
+}
+
 void saveobjchn(int fd, struct obj *otmp) {
   struct obj *otmp2;
   unsigned xl;
@@ -98,7 +850,7 @@ void saveobjchn(int fd, struct obj *otmp) {
     xl = otmp->onamelth;
     bwrite(fd, (char *)&xl, sizeof(int));
     bwrite(fd, (char *)otmp, xl + sizeof(struct obj));
-    free((char *)otmp);
+    lfree((char *)otmp);
     otmp = otmp2;
   }
   bwrite(fd, (char *)&minusone, sizeof(int));
@@ -119,7 +871,7 @@ void savemonchn(int fd, struct monst *mtmp) {
     bwrite(fd, (char *)mtmp, xl + sizeof(struct monst));
     if (mtmp->minvent)
       saveobjchn(fd, mtmp->minvent);
-    free((char *)mtmp);
+    lfree((char *)mtmp);
     mtmp = mtmp2;
   }
   bwrite(fd, (char *)&minusone, sizeof(int));
@@ -130,7 +882,7 @@ void savegoldchn(int fd, struct gold *gold) {
   while (gold) {
     gold2 = gold->ngold;
     bwrite(fd, (char *)gold, sizeof(struct gold));
-    free((char *)gold);
+    lfree((char *)gold);
     gold = gold2;
   }
   bwrite(fd, nul, sizeof(struct gold));
@@ -141,12 +893,41 @@ void savetrapchn(int fd, struct trap *trap) {
   while (trap) {
     trap2 = trap->ntrap;
     bwrite(fd, (char *)trap, sizeof(struct trap));
-    free((char *)trap);
+    lfree((char *)trap);
     trap = trap2;
   }
   bwrite(fd, nul, sizeof(struct trap));
 }
 
+/*
+ * MODERN: read the rest of the level image that began with the 4 bytes at
+ * magic. A buffered image is decoded where mbufon() put it.
+ */
+static void getlimg(int fd, char *magic, int pid, xchar lev) {
+  static char *ibuf;
+  static unsigned ibuf_size;
+  char hd[8];
+  unsigned len;
+
+  (void)memcpy(hd, magic, 4);
+  mread(fd, hd + 4, 4);
+  if ((len = limg_len(hd)) < sizeof(hd))
+    len = sizeof(hd); /* limg_load() finds it short */
+  if (fd == rbuf_fd && rbuf_pos >= sizeof(hd) &&
+      rbuf_len - rbuf_pos >= len - sizeof(hd)) {
+    rbuf_pos += len - sizeof(hd);
+    limg_load(rbuf + rbuf_pos - len, len, pid, lev);
+    return;
+  }
+  if (len > ibuf_size) {
+    ibuf_size = len;
+    ibuf = (char *)enlarge(ibuf, ibuf_size);
+  }
+  (void)memcpy(ibuf, hd, sizeof(hd));
+  mread(fd, ibuf + sizeof(hd), len - sizeof(hd));
+  limg_load(ibuf, len, pid, lev);
+}
+
 void getlev(int fd, int pid, xchar lev) {
   struct gold *gold;
   struct trap *trap;
@@ -160,6 +941,11 @@ void getlev(int fd, int pid, xchar lev) {
 
   /* First some sanity checks */
   mread(fd, (char *)&hpid, sizeof(hpid));
+  if (!memcmp((char *)&hpid, "RHLV", 4)) { /* MODERN: see hack.levimg.c */
+    getlimg(fd, (char *)&hpid, pid, lev);
+    rebuild_grid();
+    return;
+  }
   mread(fd, (char *)&dlvl, sizeof(dlvl));
   if ((pid && pid != hpid) || (lev && dlvl != lev)) {
     pline("Strange, this map is not as I remember it.");
@@ -177,58 +963,29 @@ void getlev(int fd, int pid, xchar lev) {
   mread(fd, (char *)&xdnstair, sizeof(xdnstair));
   mread(fd, (char *)&ydnstair, sizeof(ydnstair));
 
-  fmon = restmonchn(fd);
+  restmonchn(fd, &fmon);
 
-  /* regenerate animals while on another level */
-  {
-    long tmoves = (moves > omoves) ? moves - omoves : 0;
-    struct monst *mtmp, *mtmp2;
-    extern char genocided[];
-
-    for (mtmp = fmon; mtmp; mtmp = mtmp2) {
-      long newhp; /* tmoves may be very large */
-
-      mtmp2 = mtmp->nmon;
-      if (index(genocided, mtmp->data->mlet)) {
-        mondead(mtmp);
-        continue;
-      }
-
-      if (mtmp->mtame && tmoves > 250) {
-        mtmp->mtame = 0;
-        mtmp->mpeaceful = 0;
-      }
-
-      newhp =
-          mtmp->mhp + (index(MREGEN, mtmp->data->mlet) ? tmoves : tmoves / 20);
-      if (newhp > mtmp->mhpmax)
-        mtmp->mhp = mtmp->mhpmax;
-      else
-        mtmp->mhp = (schar)newhp; /* MODERN: cast to schar */
-    }
-  }
+  lev_regen(omoves);
 
   setgd();
   gold = newgold();
   mread(fd, (char *)gold, sizeof(struct gold));
   while (gold->gx) {
-    gold->ngold = fgold;
-    fgold = gold;
+    gold_link(gold);
     gold = newgold();
     mread(fd, (char *)gold, sizeof(struct gold));
   }
-  free((char *)gold);
+  lfree((char *)gold);
   trap = newtrap();
   mread(fd, (char *)trap, sizeof(struct trap));
   while (trap->tx) {
-    trap->ntrap = ftrap;
-    ftrap = trap;
+    trap_link(trap);
     trap = newtrap();
     mread(fd, (char *)trap, sizeof(struct trap));
   }
-  free((char *)trap);
-  fobj = restobjchn(fd);
-  billobjs = restobjchn(fd);
+  lfree((char *)trap);
+  restobjchn(fd, &fobj);
+  restobjchn(fd, &billobjs);
   rest_engravings(fd);
 #ifndef QUEST
   mread(fd, (char *)rooms, sizeof(rooms));
@@ -249,17 +1006,28 @@ void getlev(int fd, int pid, xchar lev) {
     }
   mread(fd, (char *)wgrowtime, sizeof(wgrowtime));
 #endif /* NOWORM */
+  rebuild_grid(); /* MODERN: index the restored monsters */
 }
 
 void mread(int fd, char *buf, unsigned len) {
   int rlen;
   extern boolean restoring;
 
-  ssize_t read_result = read(fd, buf, (size_t)len); /* MODERN: proper POSIX types */
-  rlen = (int)read_result; /* MODERN: cast ssize_t to int for compatibility */
+  if (fd == rbuf_fd) { /* MODERN: buffered by mbufon() */
+    rlen = (int)((rbuf_len - rbuf_pos < len) ? rbuf_len - rbuf_pos : len);
+    (void)memcpy(buf, rbuf + rbuf_pos, (size_t)rlen);
+    rbuf_pos += (unsigned)rlen;
+  } else {
+    ssize_t read_result = read(fd, buf, (size_t)len); /* MODERN: proper POSIX types */
+    lev_reads++;
+    rlen = (int)read_result; /* MODERN: cast ssize_t to int for compatibility */
+  }
   if (rlen !=
       (int)len) { /* MODERN: Cast to int to match rlen type from read() */
-    pline("Read %d instead of %u bytes.\n", rlen, len);
+    if (rlen < 0)
+      pline("Cannot read file #%d: %s", fd, strerror(errno));
+    else
+      pline("Read %d instead of %u bytes.\n", rlen, len);
     if (restoring) {
       (void)unlink(SAVEF);
       error("Error restoring old game.");
@@ -270,11 +1038,13 @@ void mread(int fd, char *buf, unsigned len) {
 
 void mklev(void) {
   extern boolean in_mklev;
+  /* MODERN: made from the game seed and dlevel alone, see rnd_level() */
+  int rs = rnd_level(dlevel);
 
-  if (getbones())
-    return;
-
-  in_mklev = TRUE;
-  makelevel();
-  in_mklev = FALSE;
+  if (!getbones()) {
+    in_mklev = TRUE;
+    makelevel();
+    in_mklev = FALSE;
+  }
+  rnd_level_end(rs);
 }
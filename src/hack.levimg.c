@@ -0,0 +1,897 @@
+/* hack.levimg.c - Position-independent level images
+ *
+ * MODERN ADDITION (2026): The format savelev() writes and getlev() reads.
+ *
+ * WHY: A level file was the level's structs as they lay in memory - every
+ * monster and object with its chain pointer, data pointed into mons[] and
+ * relocated on the way back by the distance mons[] had moved, name lengths
+ * in native ints, bitfields in whatever order the compiler chose. getlev()
+ * rebuilt it with two read-and-allocate steps per record, and a file was
+ * only good to the binary that wrote it (uptodate() threw away bones older
+ * than the game for that reason).
+ *
+ * HOW: An image is a header and a table of sections, each section a run of
+ * fixed-width big-endian records, found by offset from the start of the
+ * image. Nothing in it is a pointer: a monster names its kind by an index
+ * into pm_table[] and its inventory as a range of the object section;
+ * worms are ranges of the segment section; names, engraving texts and the
+ * shopkeeper, pet and guard data are offsets into the text section.
+ * limg_save() encodes a level and frees it, handing the image to bwrite()
+ * in one piece. limg_load() decodes an image where it lies - in the read
+ * buffer getlev() filled - in one pass over the records.
+ *
+ * Each table entry carries the record width next to offset and count, so
+ * a later version can widen records or add sections at the end and older
+ * readers step over what they do not know.
+ *
+ * PRESERVES: getlev() makes the same chains in the same order: gold, traps
+ * and engravings come back reversed and empty engravings dropped, zero ids
+ * are numbered as they are met, lost monsters regenerate before the
+ * objects are restored. Level files, bones and save files from before
+ * still load by the old code (the old format starts with a process id,
+ * which is never "RHLV").
+ * ADDS: Level files and bones that any build reads, about a third smaller
+ * than before; one allocation per entity and no copy on load.
+ */
+
+#include "hack.h"
+#include "def.edog.h"
+#include "def.eshk.h"
+#ifndef NOWORM
+#include "def.wseg.h"
+extern struct wseg *wsegs[32], *wheads[32];
+extern long wgrowtime[32];
+#endif /* NOWORM */
+#include <unistd.h>
+
+extern struct obj *billobjs;
+extern char SAVEF[];
+extern int hackpid;
+extern struct permonst pm_ghost, pm_wizard, pm_eel;
+#ifdef MAIL
+extern struct permonst pm_mail_daemon;
+#endif /* MAIL */
+extern struct permonst li_dog, dog, la_dog, hell_hound;
+#ifndef QUEST
+extern struct permonst pm_guard;
+#endif /* QUEST */
+
+#define LI_MAGIC "RHLV"
+#define LI_VERSION 1
+#define LI_HEAD 40 /* bytes before the section table */
+
+/* sections, in the order of the table */
+#define LS_LEVL 0  /* 2 bytes a square, column by column */
+#define LS_MONST 1 /* fmon */
+#define LS_OBJ 2   /* fobj, billobjs, then each monster's inventory */
+#define LS_GOLD 3
+#define LS_TRAP 4
+#define LS_ENGR 5
+#define LS_ROOM 6
+#define LS_DOOR 7
+#define LS_WORM 8 /* per worm number: its segments, growth time */
+#define LS_WSEG 9
+#define LS_TEXT 10 /* names, engravings, monster data; record width 1 */
+#define LS_N 11
+
+/* record widths this version writes, and the least it reads */
+static const unsigned li_width[LS_N] = {2, 72, 48, 10, 4, 20, 8, 2, 16, 3, 1};
+
+/* monster data kinds (mextra) */
+#define LX_NONE 0
+#define LX_BYTES 1 /* as it lies in memory (the ghost's name) */
+#define LX_ESHK 2
+#define LX_EDOG 3
+#define LX_EGD 4
+
+/*
+ * Every permonst a monster can point to; an image stores the index. New
+ * entries go at the end, a build without one keeps its place with 0.
+ */
+static struct permonst *const pm_extra[] = {&pm_ghost, &pm_wizard, &pm_eel,
+#ifdef MAIL
+                                            &pm_mail_daemon,
+#else
+                                            0,
+#endif /* MAIL */
+#ifndef QUEST
+                                            &pm_guard,
+#else
+                                            0,
+#endif /* QUEST */
+                                            &li_dog, &dog, &la_dog,
+                                            &hell_hound};
+#define PM_COMMON (CMNUM + 2) /* mons[], shopkeeper included */
+
+static int pm_index(struct permonst *ptr) {
+  int i;
+
+  if (ptr >= &mons[0] && ptr < &mons[PM_COMMON])
+    return ((int)(ptr - mons));
+  for (i = 0; i < SIZE(pm_extra); i++)
+    if (ptr == pm_extra[i])
+      return (PM_COMMON + i);
+  impossible("Level image: unknown monster type '%c'", ptr->mlet, 0);
+  return (0);
+}
+
+static struct permonst *pm_table(unsigned long i) {
+  if (i < PM_COMMON)
+    return (&mons[i]);
+  if (i - PM_COMMON < SIZE(pm_extra))
+    return (pm_extra[i - PM_COMMON]);
+  return (0);
+}
+
+/* ---- writing ---- */
+
+static struct limg sect[LS_N], whole;
+
+static void li_grow(struct limg *w, unsigned num) {
+  if (w->len + num > w->size) {
+    while (w->len + num > w->size)
+      w->size = w->size ? 2 * w->size : 1024;
+    w->buf = (char *)enlarge(w->buf, w->size);
+  }
+}
+
+/* the low width bytes of v, most significant first */
+void li_put(struct limg *w, unsigned long v, int width) {
+  li_grow(w, (unsigned)width);
+  while (width-- > 0)
+    w->buf[w->len++] = (char)((v >> (8 * width)) & 0xff);
+}
+
+/* a long in 8 bytes, whatever its size here */
+void li_long(struct limg *w, long v) {
+  long hi = v < 0 ? -1L : 0L;
+
+  if (sizeof(long) > 4)
+    hi = (long)((v >> 16) >> 16);
+  li_put(w, (unsigned long)hi & 0xffffffffUL, 4);
+  li_put(w, (unsigned long)v & 0xffffffffUL, 4);
+}
+
+void li_bytes(struct limg *w, const char *s, unsigned n) {
+  if (n == 0) /* s may be the buffer of a section never written to */
+    return;
+  li_grow(w, n);
+  (void)memcpy(w->buf + w->len, s, (size_t)n);
+  w->len += n;
+}
+
+/* n bytes of s into the text section; its offset there */
+unsigned li_text(const char *s, unsigned n) {
+  unsigned off = sect[LS_TEXT].len;
+
+  li_bytes(&sect[LS_TEXT], s, n);
+  return (off);
+}
+
+static void li_obj(struct obj *otmp) {
+  struct limg *w = &sect[LS_OBJ];
+
+  li_put(w, otmp->o_id, 4);
+  li_put(w, otmp->o_cnt_id, 4);
+  li_put(w, (uchar)otmp->ox, 1);
+  li_put(w, (uchar)otmp->oy, 1);
+  li_put(w, (uchar)otmp->odx, 1);
+  li_put(w, (uchar)otmp->ody, 1);
+  li_put(w, otmp->otyp, 1);
+  li_put(w, otmp->owt, 1);
+  li_put(w, otmp->quan, 1);
+  li_put(w, (uchar)otmp->spe, 1);
+  li_put(w, (uchar)otmp->olet, 1);
+  li_put(w, (uchar)otmp->invlet, 1);
+  li_put(w, (unsigned long)(otmp->oinvis | otmp->odispl << 1 |
+                            otmp->known << 2 | otmp->dknown << 3 |
+                            otmp->cursed << 4 | otmp->unpaid << 5 |
+                            otmp->rustfree << 6),
+         1);
+  li_put(w, otmp->onamelth, 1);
+  li_long(w, otmp->age);
+  li_long(w, otmp->owornmask);
+  li_long(w, otmp->oextra[0]);
+  li_put(w, otmp->onamelth ? li_text(ONAME(otmp), otmp->onamelth) : 0, 4);
+}
+
+/* write a chain of objects and free it; how many there were */
+static unsigned li_objchn(struct obj *otmp) {
+  struct obj *otmp2;
+  unsigned n = 0;
+
+  for (; otmp; otmp = otmp2) {
+    otmp2 = otmp->nobj;
+    li_obj(otmp);
+    lfree((char *)otmp);
+    n++;
+  }
+  return (n);
+}
+
+/* the monster's extra data into the text section */
+static int li_mextra(struct monst *mtmp) {
+  struct limg *w = &sect[LS_TEXT];
+  struct eshk *esk;
+  struct edog *edog;
+  int i;
+
+  if (!mtmp->mxlth)
+    return (LX_NONE);
+  if (mtmp->isshk && mtmp->mxlth == sizeof(struct eshk)) {
+    esk = (struct eshk *)mtmp->mextra;
+    li_long(w, esk->robbed);
+    li_put(w, (uchar)esk->following, 1);
+    li_put(w, (uchar)esk->shoproom, 1);
+    li_put(w, (uchar)esk->shk.x, 1);
+    li_put(w, (uchar)esk->shk.y, 1);
+    li_put(w, (uchar)esk->shd.x, 1);
+    li_put(w, (uchar)esk->shd.y, 1);
+    li_put(w, (unsigned long)esk->shoplevel, 4);
+    li_put(w, (unsigned long)esk->billct, 4);
+    for (i = 0; i < BILLSZ; i++) {
+      li_put(w, esk->bill[i].bo_id, 4);
+      li_put(w, esk->bill[i].useup | esk->bill[i].bquan << 1, 1);
+      li_put(w, esk->bill[i].price, 4);
+    }
+    li_put(w, (unsigned long)esk->visitct, 4);
+    li_bytes(w, esk->customer, PL_NSIZ);
+    li_bytes(w, esk->shknam, PL_NSIZ);
+    return (LX_ESHK);
+  }
+  if (mtmp->isgd && mtmp->mxlth == egd_size()) {
+    egd_image(w, mtmp);
+    return (LX_EGD);
+  }
+  if (mtmp->data != PM_GHOST && mtmp->mxlth == sizeof(struct edog)) {
+    edog = EDOG(mtmp);
+    li_long(w, edog->hungrytime);
+    li_long(w, edog->eattime);
+    li_long(w, edog->droptime);
+    li_put(w, edog->dropdist, 4);
+    li_put(w, edog->apport, 4);
+    li_long(w, edog->whistletime);
+    return (LX_EDOG);
+  }
+  li_bytes(w, (char *)mtmp->mextra, mtmp->mxlth);
+  return (LX_BYTES);
+}
+
+static void li_mon(struct monst *mtmp, unsigned inv, unsigned ninv) {
+  struct limg *w = &sect[LS_MONST];
+  unsigned xoff = sect[LS_TEXT].len, name;
+  int i, kind;
+
+  kind = li_mextra(mtmp);
+  name = mtmp->mnamelth ? li_text(NAME(mtmp), mtmp->mnamelth) : 0;
+  li_put(w, mtmp->m_id, 4);
+  li_put(w, (unsigned long)pm_index(mtmp->data), 2);
+  li_put(w, (uchar)mtmp->mx, 1);
+  li_put(w, (uchar)mtmp->my, 1);
+  li_put(w, (uchar)mtmp->mdx, 1);
+  li_put(w, (uchar)mtmp->mdy, 1);
+  for (i = 0; i < MTSZ; i++) {
+    li_put(w, (uchar)mtmp->mtrack[i].x, 1);
+    li_put(w, (uchar)mtmp->mtrack[i].y, 1);
+  }
+  li_put(w, (uchar)mtmp->mhp, 1);
+  li_put(w, (uchar)mtmp->mhpmax, 1);
+  li_put(w, (uchar)mtmp->mappearance, 1);
+  li_put(w, mtmp->mspeed, 1);
+  li_put(w, mtmp->mfleetim, 1);
+  li_put(w, mtmp->mblinded, 1);
+#ifndef NOWORM
+  li_put(w, mtmp->wormno, 1);
+#else
+  li_put(w, 0, 1);
+#endif /* NOWORM */
+  li_put(w, mtmp->mnamelth, 1);
+  li_put(w, (unsigned long)(mtmp->mimic | mtmp->mdispl << 1 |
+                            mtmp->minvis << 2 | mtmp->cham << 3 |
+                            mtmp->mhide << 4 | mtmp->mundetected << 5 |
+                            mtmp->msleep << 6 | mtmp->mfroz << 7 |
+                            mtmp->mconf << 8 | mtmp->mflee << 9 |
+                            mtmp->mcan << 10 | mtmp->mtame << 11 |
+                            mtmp->mpeaceful << 12 | mtmp->isshk << 13 |
+                            mtmp->isgd << 14 | mtmp->mcansee << 15 |
+                            (unsigned long)mtmp->mtrapped << 16),
+         4);
+  li_put(w, mtmp->mtrapseen, 4);
+  li_long(w, mtmp->mlstmv);
+  li_long(w, mtmp->mgold);
+  li_put(w, inv, 4);
+  li_put(w, ninv, 4);
+  li_put(w, (unsigned long)kind, 1);
+  li_put(w, 0, 1);
+  li_put(w, kind == LX_NONE ? 0 : xoff, 4);
+  li_put(w, sect[LS_TEXT].len - (name ? mtmp->mnamelth : 0) - xoff, 4);
+  li_put(w, name, 4);
+}
+
+/*
+ * Encode the level in memory and bwrite() it to fd, freeing its monsters,
+ * objects, gold, traps, engravings and worms. The caller clears the level
+ * globals.
+ */
+void limg_save(int fd, unsigned char lev) {
+  struct monst *mtmp, *mtmp2;
+  struct gold *gold, *gold2;
+  struct trap *trap, *trap2;
+  struct obj *otmp;
+  unsigned nobj, nfobj, nbill, n, off;
+  int s, x, y;
+#ifndef NOWORM
+  struct wseg *wtmp, *wtmp2;
+#endif /* NOWORM */
+
+  for (s = 0; s < LS_N; s++)
+    sect[s].len = 0;
+  li_put(&sect[LS_TEXT], 0, 1); /* offset 0 is "none" */
+
+  for (x = 0; x < COLNO; x++)
+    for (y = 0; y < ROWNO; y++) {
+      li_put(&sect[LS_LEVL], (uchar)levl[x][y].scrsym, 1);
+      li_put(&sect[LS_LEVL],
+             (unsigned long)(levl[x][y].typ | levl[x][y].new << 5 |
+                             levl[x][y].seen << 6 | levl[x][y].lit << 7),
+             1);
+    }
+
+  nfobj = li_objchn(fobj);
+  nbill = li_objchn(billobjs);
+  billobjs = 0;
+  nobj = nfobj + nbill;
+  for (mtmp = fmon; mtmp; mtmp = mtmp2) {
+    mtmp2 = mtmp->nmon;
+    n = 0;
+    for (otmp = mtmp->minvent; otmp; otmp = otmp->nobj)
+      n++;
+    li_mon(mtmp, nobj, n);
+    (void)li_objchn(mtmp->minvent);
+    nobj += n;
+    lfree((char *)mtmp);
+  }
+
+  for (gold = fgold; gold; gold = gold2) {
+    gold2 = gold->ngold;
+    li_put(&sect[LS_GOLD], (uchar)gold->gx, 1);
+    li_put(&sect[LS_GOLD], (uchar)gold->gy, 1);
+    li_long(&sect[LS_GOLD], gold->amount);
+    lfree((char *)gold);
+  }
+  for (trap = ftrap; trap; trap = trap2) {
+    trap2 = trap->ntrap;
+    li_put(&sect[LS_TRAP], (uchar)trap->tx, 1);
+    li_put(&sect[LS_TRAP], (uchar)trap->ty, 1);
+    li_put(&sect[LS_TRAP], trap->ttyp, 1);
+    li_put(&sect[LS_TRAP], trap->tseen | trap->once << 1, 1);
+    lfree((char *)trap);
+  }
+  engr_image(&sect[LS_ENGR]);
+
+#ifndef QUEST
+  for (s = 0; s < SIZE(rooms); s++) {
+    li_put(&sect[LS_ROOM], (uchar)rooms[s].lx, 1);
+    li_put(&sect[LS_ROOM], (uchar)rooms[s].hx, 1);
+    li_put(&sect[LS_ROOM], (uchar)rooms[s].ly, 1);
+    li_put(&sect[LS_ROOM], (uchar)rooms[s].hy, 1);
+    li_put(&sect[LS_ROOM], (uchar)rooms[s].rtype, 1);
+    li_put(&sect[LS_ROOM], (uchar)rooms[s].rlit, 1);
+    li_put(&sect[LS_ROOM], (uchar)rooms[s].doorct, 1);
+    li_put(&sect[LS_ROOM], (uchar)rooms[s].fdoor, 1);
+  }
+  for (s = 0; s < DOORMAX; s++) {
+    li_put(&sect[LS_DOOR], (uchar)doors[s].x, 1);
+    li_put(&sect[LS_DOOR], (uchar)doors[s].y, 1);
+  }
+#endif /* QUEST */
+#ifndef NOWORM
+  for (s = 0, n = 0; s < 32; s++) {
+    li_put(&sect[LS_WORM], n, 4);
+    for (wtmp = wsegs[s], off = n; s && wtmp; wtmp = wtmp2, n++) {
+      wtmp2 = wtmp->nseg;
+      li_put(&sect[LS_WSEG], (uchar)wtmp->wx, 1);
+      li_put(&sect[LS_WSEG], (uchar)wtmp->wy, 1);
+      li_put(&sect[LS_WSEG], wtmp->wdispl, 1);
+      lfree((char *)wtmp);
+    }
+    li_put(&sect[LS_WORM], n - off, 4);
+    li_long(&sect[LS_WORM], wgrowtime[s]);
+    wsegs[s] = 0;
+  }
+#endif /* NOWORM */
+
+  whole.len = 0;
+  li_bytes(&whole, LI_MAGIC, 4);
+  li_put(&whole, 0, 4); /* length, below */
+  li_put(&whole, LI_VERSION, 2);
+  li_put(&whole, LS_N, 2);
+  li_put(&whole, (unsigned long)hackpid, 4);
+  li_put(&whole, lev, 1);
+  li_put(&whole, xupstair, 1);
+  li_put(&whole, yupstair, 1);
+  li_put(&whole, xdnstair, 1);
+  li_put(&whole, ydnstair, 1);
+  li_put(&whole, 0, 3);
+  li_long(&whole, moves);
+  li_put(&whole, nfobj, 4);
+  li_put(&whole, nbill, 4);
+  off = LI_HEAD + 12 * LS_N;
+  for (s = 0; s < LS_N; s++) {
+    li_put(&whole, off, 4);
+    li_put(&whole, sect[s].len / li_width[s], 4);
+    li_put(&whole, li_width[s], 4);
+    off += sect[s].len;
+  }
+  for (s = 0; s < LS_N; s++)
+    li_bytes(&whole, sect[s].buf, sect[s].len);
+  whole.len = 4;
+  li_put(&whole, off, 4);
+  bwrite(fd, whole.buf, off);
+}
+
+/* ---- reading ---- */
+
+static const unsigned char *img; /* the image being loaded */
+static unsigned sect_off[LS_N], sect_cnt[LS_N], sect_width[LS_N];
+
+static void li_damaged(const char *what) {
+  extern boolean restoring;
+
+  pline("This level file is damaged (%s).", what);
+  if (restoring) {
+    (void)unlink(SAVEF);
+    error("Error restoring old game.");
+  }
+  panic("Error reading level file.");
+}
+
+unsigned long li_get(struct lrd *r, int width) {
+  unsigned long v = 0;
+
+  if (r->end - r->p < width)
+    li_damaged("short record");
+  while (width-- > 0)
+    v = (v << 8) | *r->p++;
+  return (v);
+}
+
+long li_getlong(struct lrd *r) {
+  unsigned long hi = li_get(r, 4), lo = li_get(r, 4);
+
+  if (sizeof(long) > 4)
+    return ((long)(((hi << 16) << 16) | lo));
+  return ((long)lo); /* the low word, as it was stored from here */
+}
+
+void li_getbytes(struct lrd *r, char *s, unsigned n) {
+  if ((unsigned)(r->end - r->p) < n)
+    li_damaged("short record");
+  (void)memcpy(s, r->p, (size_t)n);
+  r->p += n;
+}
+
+/* record i of section s; the reader sees exactly its bytes */
+void li_record(int s, unsigned i, struct lrd *r) {
+  if (i >= sect_cnt[s])
+    li_damaged("record out of range");
+  r->p = img + sect_off[s] + i * sect_width[s];
+  r->end = r->p + sect_width[s];
+}
+
+/* (x,y) from the image must be a square of the map */
+void li_onmap(int x, int y) {
+  if (!isok(x, y))
+    li_damaged("off the map");
+}
+
+/* n bytes at off in the text section */
+void li_gettext(unsigned off, unsigned n, struct lrd *r) {
+  if (off > sect_cnt[LS_TEXT] || n > sect_cnt[LS_TEXT] - off)
+    li_damaged("text out of range");
+  r->p = img + sect_off[LS_TEXT] + off;
+  r->end = r->p + n;
+}
+
+/* the length of the image whose first 8 bytes are at hd; 0 if not one */
+unsigned limg_len(const char *hd) {
+  struct lrd r;
+
+  if (memcmp(hd, LI_MAGIC, 4))
+    return (0);
+  r.p = (const unsigned char *)hd + 4;
+  r.end = r.p + 4;
+  return ((unsigned)li_get(&r, 4));
+}
+
+/* does the file fd is open on hold a level image? */
+boolean limg_file(int fd) {
+  char hd[4];
+
+  return (pread(fd, hd, sizeof(hd), (off_t)0) == sizeof(hd) &&
+          !memcmp(hd, LI_MAGIC, 4));
+}
+
+static struct obj *li_getobj(unsigned i) {
+  struct obj *otmp;
+  struct lrd r, t;
+  unsigned bits, nl, name;
+
+  li_record(LS_OBJ, i, &r);
+  nl = r.p[19] & 077; /* onamelth */
+  otmp = newobj(nl > 0 ? nl + 1 : 0); /* room for a NUL, as restobjchn() */
+  (void)memset((char *)otmp, 0, sizeof(struct obj));
+  otmp->o_id = (unsigned)li_get(&r, 4);
+  otmp->o_cnt_id = (unsigned)li_get(&r, 4);
+  otmp->ox = (xchar)li_get(&r, 1);
+  otmp->oy = (xchar)li_get(&r, 1);
+  otmp->odx = (xchar)li_get(&r, 1);
+  otmp->ody = (xchar)li_get(&r, 1);
+  /* NROFOBJECTS is the last object, not the count */
+  if ((otmp->otyp = (uchar)li_get(&r, 1)) > NROFOBJECTS)
+    li_damaged("unknown object");
+  otmp->owt = (uchar)li_get(&r, 1);
+  otmp->quan = (uchar)li_get(&r, 1);
+  otmp->spe = (schar)li_get(&r, 1);
+  otmp->olet = (char)li_get(&r, 1);
+  otmp->invlet = (char)li_get(&r, 1);
+  bits = (unsigned)li_get(&r, 1);
+  otmp->oinvis = bits & 1;
+  otmp->odispl = (bits >> 1) & 1;
+  otmp->known = (bits >> 2) & 1;
+  otmp->dknown = (bits >> 3) & 1;
+  otmp->cursed = (bits >> 4) & 1;
+  otmp->unpaid = (bits >> 5) & 1;
+  otmp->rustfree = (bits >> 6) & 1;
+  otmp->onamelth = (unsigned)li_get(&r, 1) & 077;
+  otmp->age = li_getlong(&r);
+  otmp->owornmask = li_getlong(&r);
+  otmp->oextra[0] = li_getlong(&r);
+  name = (unsigned)li_get(&r, 4);
+  if (nl) {
+    li_gettext(name, nl, &t);
+    li_getbytes(&t, ONAME(otmp), nl);
+    ONAME(otmp)[nl] = '\0';
+  }
+  if (!otmp->o_id)
+    otmp->o_id = flags.ident++;
+  id_obj(otmp); /* see hack.ident.c */
+  return (otmp);
+}
+
+/* objects first .. first+n-1 as a chain */
+static struct obj *li_getobjchn(unsigned first, unsigned n) {
+  struct obj *head = 0, **otail = &head;
+
+  while (n--) {
+    *otail = li_getobj(first++);
+    otail = &(*otail)->nobj;
+  }
+  return (head);
+}
+
+/* the size here of a monster data kind; 0 for one this build lacks */
+static unsigned li_xsize(int kind, unsigned xlen) {
+  switch (kind) {
+  case LX_NONE:
+    return (0);
+  case LX_BYTES:
+    return (xlen);
+  case LX_ESHK:
+    return (sizeof(struct eshk));
+  case LX_EDOG:
+    return (sizeof(struct edog));
+  case LX_EGD:
+    return (egd_size());
+  }
+  li_damaged("unknown monster data");
+  return (0);
+}
+
+static void li_getmextra(struct monst *mtmp, int kind, struct lrd *t) {
+  struct eshk *esk;
+  struct edog *edog;
+  unsigned bits;
+  int i;
+
+  switch (kind) {
+  case LX_BYTES:
+    li_getbytes(t, (char *)mtmp->mextra, mtmp->mxlth);
+    break;
+  case LX_ESHK:
+    esk = (struct eshk *)mtmp->mextra;
+    esk->robbed = li_getlong(t);
+    esk->following = (boolean)li_get(t, 1);
+    esk->shoproom = (schar)li_get(t, 1);
+    esk->shk.x = (xchar)li_get(t, 1);
+    esk->shk.y = (xchar)li_get(t, 1);
+    esk->shd.x = (xchar)li_get(t, 1);
+    esk->shd.y = (xchar)li_get(t, 1);
+    esk->shoplevel = (int)li_get(t, 4);
+    esk->billct = (int)li_get(t, 4);
+    for (i = 0; i < BILLSZ; i++) {
+      esk->bill[i].bo_id = (unsigned)li_get(t, 4);
+      bits = (unsigned)li_get(t, 1);
+      esk->bill[i].useup = bits & 1;
+      esk->bill[i].bquan = (bits >> 1) & 0177;
+      esk->bill[i].price = (unsigned)li_get(t, 4);
+    }
+    esk->visitct = (int)li_get(t, 4);
+    li_getbytes(t, esk->customer, PL_NSIZ);
+    li_getbytes(t, esk->shknam, PL_NSIZ);
+    break;
+  case LX_EDOG:
+    edog = EDOG(mtmp);
+    edog->hungrytime = li_getlong(t);
+    edog->eattime = li_getlong(t);
+    edog->droptime = li_getlong(t);
+    edog->dropdist = (unsigned)li_get(t, 4);
+    edog->apport = (unsigned)li_get(t, 4);
+    edog->whistletime = li_getlong(t);
+    break;
+  case LX_EGD:
+    egd_unimage(t, mtmp);
+    break;
+  }
+}
+
+static struct monst *li_getmon(unsigned i) {
+  struct monst *mtmp;
+  struct permonst *ptr;
+  struct lrd r, t;
+  unsigned bits, inv, ninv, xoff, xlen, xl, nl, name;
+  int j, kind;
+
+  li_record(LS_MONST, i, &r);
+  nl = r.p[25] & 077; /* mnamelth */
+  t.p = r.p + 58;     /* the data and name, to size the allocation */
+  t.end = r.end;
+  kind = (int)li_get(&t, 1);
+  t.p++;
+  xoff = (unsigned)li_get(&t, 4);
+  xlen = (unsigned)li_get(&t, 4);
+  name = (unsigned)li_get(&t, 4);
+  xl = li_xsize(kind, xlen);
+  mtmp = newmonst(xl + nl);
+  (void)memset((char *)mtmp, 0, sizeof(struct monst));
+  mtmp->mxlth = xl;
+  mtmp->mnamelth = nl;
+  mtmp->m_id = (unsigned)li_get(&r, 4);
+  if (!(ptr = pm_table(li_get(&r, 2))))
+    li_damaged("unknown monster");
+  mtmp->data = ptr;
+  mtmp->mx = (xchar)li_get(&r, 1);
+  mtmp->my = (xchar)li_get(&r, 1);
+  mtmp->mdx = (xchar)li_get(&r, 1);
+  mtmp->mdy = (xchar)li_get(&r, 1);
+  for (j = 0; j < MTSZ; j++) {
+    mtmp->mtrack[j].x = (xchar)li_get(&r, 1);
+    mtmp->mtrack[j].y = (xchar)li_get(&r, 1);
+  }
+  mtmp->mhp = (schar)li_get(&r, 1);
+  mtmp->mhpmax = (schar)li_get(&r, 1);
+  mtmp->mappearance = (char)li_get(&r, 1);
+  mtmp->mspeed = (unsigned)li_get(&r, 1) & 03;
+  mtmp->mfleetim = (unsigned)li_get(&r, 1) & 0177;
+  mtmp->mblinded = (unsigned)li_get(&r, 1) & 0177;
+#ifndef NOWORM
+  mtmp->wormno = (unsigned)li_get(&r, 1) & 037;
+#else
+  (void)li_get(&r, 1);
+#endif /* NOWORM */
+  (void)li_get(&r, 1); /* mnamelth, above */
+  bits = (unsigned)li_get(&r, 4);
+  mtmp->mimic = bits & 1;
+  mtmp->mdispl = (bits >> 1) & 1;
+  mtmp->minvis = (bits >> 2) & 1;
+  mtmp->cham = (bits >> 3) & 1;
+  mtmp->mhide = (bits >> 4) & 1;
+  mtmp->mundetected = (bits >> 5) & 1;
+  mtmp->msleep = (bits >> 6) & 1;
+  mtmp->mfroz = (bits >> 7) & 1;
+  mtmp->mconf = (bits >> 8) & 1;
+  mtmp->mflee = (bits >> 9) & 1;
+  mtmp->mcan = (bits >> 10) & 1;
+  mtmp->mtame = (bits >> 11) & 1;
+  mtmp->mpeaceful = (bits >> 12) & 1;
+  mtmp->isshk = (bits >> 13) & 1;
+  mtmp->isgd = (bits >> 14) & 1;
+  mtmp->mcansee = (bits >> 15) & 1;
+  mtmp->mtrapped = (bits >> 16) & 1;
+  mtmp->mtrapseen = (unsigned)li_get(&r, 4);
+  mtmp->mlstmv = li_getlong(&r);
+  mtmp->mgold = li_getlong(&r);
+  inv = (unsigned)li_get(&r, 4);
+  ninv = (unsigned)li_get(&r, 4);
+  if (kind != LX_NONE) {
+    li_gettext(xoff, xlen, &t);
+    li_getmextra(mtmp, kind, &t);
+  }
+  if (nl) {
+    li_gettext(name, nl, &t);
+    li_getbytes(&t, NAME(mtmp), nl);
+  }
+  if (!mtmp->m_id)
+    mtmp->m_id = flags.ident++;
+  id_mon(mtmp); /* see hack.ident.c */
+  mtmp->minvent = li_getobjchn(inv, ninv);
+  obj_head(&mtmp->minvent);
+  return (mtmp);
+}
+
+/*
+ * getlev() from the image of len bytes at p. pid and lev, when not 0,
+ * must match the process and level that wrote it.
+ */
+void limg_load(const char *p, unsigned len, int pid, xchar lev) {
+  struct monst **mtail = &fmon;
+  struct obj *otmp;
+  struct gold *gold;
+  struct trap *trap;
+  struct lrd r;
+  unsigned nsect, nfobj, nbill, i, bits;
+  long omoves;
+  int s, x, y, hpid;
+  xchar dlvl;
+  uchar stairs[4];
+#ifndef NOWORM
+  struct wseg *wtmp;
+  unsigned first, n;
+#endif /* NOWORM */
+
+  img = (const unsigned char *)p;
+  r.p = img + 8;
+  r.end = img + (len < LI_HEAD ? len : LI_HEAD);
+  if (li_get(&r, 2) != LI_VERSION)
+    li_damaged("written by a newer game");
+  nsect = (unsigned)li_get(&r, 2);
+  hpid = (int)li_get(&r, 4);
+  dlvl = (xchar)li_get(&r, 1);
+  for (i = 0; i < 4; i++)
+    stairs[i] = (uchar)li_get(&r, 1);
+  r.p += 3;
+  omoves = li_getlong(&r);
+  nfobj = (unsigned)li_get(&r, 4);
+  nbill = (unsigned)li_get(&r, 4);
+  r.end = img + len;
+  for (s = 0; s < LS_N; s++) {
+    sect_off[s] = sect_cnt[s] = 0;
+    sect_width[s] = li_width[s];
+    if ((unsigned)s >= nsect)
+      continue; /* written before this section was */
+    sect_off[s] = (unsigned)li_get(&r, 4);
+    sect_cnt[s] = (unsigned)li_get(&r, 4);
+    sect_width[s] = (unsigned)li_get(&r, 4);
+    if (sect_width[s] < li_width[s] || sect_off[s] > len ||
+        (sect_cnt[s] &&
+         (len - sect_off[s]) / sect_width[s] < sect_cnt[s]))
+      li_damaged("bad section table");
+  }
+  if (sect_cnt[LS_LEVL] != COLNO * ROWNO || nfobj + nbill > sect_cnt[LS_OBJ])
+    li_damaged("not a level of this size");
+  for (i = 0; i < 4; i += 2)
+    if (stairs[i]) /* 0: no such stairs */
+      li_onmap(stairs[i], stairs[i + 1]);
+
+  /* First some sanity checks */
+  if ((pid && pid != hpid) || (lev && dlvl != lev)) {
+    pline("Strange, this map is not as I remember it.");
+    pline("Somebody is trying some trickery here ...");
+    pline("This game is void ...");
+    done("tricked");
+  }
+
+  fgold = 0;
+  ftrap = 0;
+  for (x = 0; x < COLNO; x++)
+    for (y = 0; y < ROWNO; y++) {
+      li_record(LS_LEVL, (unsigned)(x * ROWNO + y), &r);
+      levl[x][y].scrsym = (char)li_get(&r, 1);
+      bits = (unsigned)li_get(&r, 1);
+      levl[x][y].typ = bits & 037;
+      levl[x][y].new = (bits >> 5) & 1;
+      levl[x][y].seen = (bits >> 6) & 1;
+      levl[x][y].lit = (bits >> 7) & 1;
+    }
+  xupstair = stairs[0];
+  yupstair = stairs[1];
+  xdnstair = stairs[2];
+  ydnstair = stairs[3];
+
+  fmon = 0;
+  for (i = 0; i < sect_cnt[LS_MONST]; i++) {
+    *mtail = li_getmon(i);
+    li_onmap((*mtail)->mx, (*mtail)->my);
+    mtail = &(*mtail)->nmon;
+  }
+  mon_head(&fmon);
+
+  lev_regen(omoves);
+
+  setgd();
+  for (i = 0; i < sect_cnt[LS_GOLD]; i++) {
+    li_record(LS_GOLD, i, &r);
+    gold = newgold();
+    gold->gx = (xchar)li_get(&r, 1);
+    gold->gy = (xchar)li_get(&r, 1);
+    li_onmap(gold->gx, gold->gy);
+    gold->amount = li_getlong(&r);
+    gold_link(gold);
+  }
+  for (i = 0; i < sect_cnt[LS_TRAP]; i++) {
+    li_record(LS_TRAP, i, &r);
+    trap = newtrap();
+    trap->tx = (xchar)li_get(&r, 1);
+    trap->ty = (xchar)li_get(&r, 1);
+    li_onmap(trap->tx, trap->ty);
+    trap->ttyp = (unsigned)li_get(&r, 1) & 037;
+    bits = (unsigned)li_get(&r, 1);
+    trap->tseen = bits & 1;
+    trap->once = (bits >> 1) & 1;
+    trap_link(trap);
+  }
+  fobj = li_getobjchn(0, nfobj);
+  obj_head(&fobj);
+  for (otmp = fobj; otmp; otmp = otmp->nobj)
+    li_onmap(otmp->ox, otmp->oy);
+  billobjs = li_getobjchn(nfobj, nbill);
+  obj_head(&billobjs);
+  for (i = 0; i < sect_cnt[LS_ENGR]; i++) {
+    li_record(LS_ENGR, i, &r);
+    engr_unimage(&r);
+  }
+#ifndef QUEST
+  for (s = 0; s < SIZE(rooms) - 1 && (unsigned)s < sect_cnt[LS_ROOM]; s++) {
+    li_record(LS_ROOM, (unsigned)s, &r);
+    rooms[s].lx = (schar)li_get(&r, 1);
+    rooms[s].hx = (schar)li_get(&r, 1);
+    rooms[s].ly = (schar)li_get(&r, 1);
+    rooms[s].hy = (schar)li_get(&r, 1);
+    rooms[s].rtype = (schar)li_get(&r, 1);
+    rooms[s].rlit = (schar)li_get(&r, 1);
+    rooms[s].doorct = (schar)li_get(&r, 1);
+    rooms[s].fdoor = (schar)li_get(&r, 1);
+    if (rooms[s].hx < 0)
+      break;
+    li_onmap(rooms[s].lx, rooms[s].ly);
+    li_onmap(rooms[s].hx, rooms[s].hy);
+    if (rooms[s].fdoor < 0 || rooms[s].doorct < 0 ||
+        rooms[s].fdoor + rooms[s].doorct > DOORMAX)
+      li_damaged("bad room");
+  }
+  rooms[s].hx = -1; /* whatever the image held, the list ends */
+  for (s = 0; s < DOORMAX && (unsigned)s < sect_cnt[LS_DOOR]; s++) {
+    li_record(LS_DOOR, (unsigned)s, &r);
+    doors[s].x = (xchar)li_get(&r, 1);
+    doors[s].y = (xchar)li_get(&r, 1);
+  }
+  for (s = 0; rooms[s].hx >= 0; s++) /* only these doors are ever used */
+    for (i = 0; i < (unsigned)rooms[s].doorct; i++)
+      li_onmap(doors[rooms[s].fdoor + i].x, doors[rooms[s].fdoor + i].y);
+#endif /* QUEST */
+#ifndef NOWORM
+  for (s = 0; s < 32 && (unsigned)s < sect_cnt[LS_WORM]; s++) {
+    li_record(LS_WORM, (unsigned)s, &r);
+    first = (unsigned)li_get(&r, 4);
+    n = (unsigned)li_get(&r, 4);
+    wgrowtime[s] = li_getlong(&r);
+    wsegs[s] = 0;
+    if (!s || !n)
+      continue;
+    wheads[s] = wsegs[s] = wtmp = newseg();
+    for (;;) {
+      li_record(LS_WSEG, first++, &r);
+      wtmp->wx = (xchar)li_get(&r, 1);
+      wtmp->wy = (xchar)li_get(&r, 1);
+      li_onmap(wtmp->wx, wtmp->wy);
+      wtmp->wdispl = (unsigned)li_get(&r, 1) & 1;
+      wtmp->nseg = 0;
+      if (!--n)
+        break;
+      wheads[s]->nseg = wtmp = newseg();
+      wheads[s] = wtmp;
+    }
+  }
+#endif /* NOWORM */
+  img = 0;
+}
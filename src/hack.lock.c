@@ -109,8 +109,11 @@ int modern_lock_record(void) {
     return 0; /* Fail silently like original */
   }
 
-  /* Try to acquire exclusive lock with shorter timeout for record updates */
-  while (attempts < 5) {
+  /* Try to acquire exclusive lock with shorter timeout for record updates.
+   * MODERN (2026): the lock now covers only a publish of well under a
+   * millisecond, so poll every millisecond within the same half second
+   * instead of sleeping a tenth of one between tries. */
+  while (attempts < 500) {
     if (flock(fd, LOCK_EX | LOCK_NB) == 0) {
       record_lock_fd = fd;
       return 1; /* Success */
@@ -122,7 +125,7 @@ int modern_lock_record(void) {
     }
 
     /* Brief wait for record lock */
-    usleep(100000); /* 0.1 seconds */
+    usleep(1000); /* 0.001 seconds */
     attempts++;
   }
 
@@ -75,17 +75,19 @@ char *catmore; /* default pager */
 #endif
 char SAVEF[PL_NSIZ + 11] = "save/"; /* save/99999player */
 char *hname;                        /* name of the game (argv[0] of call) */
-char obuf[BUFSIZ];                  /* BUFSIZ is defined in stdio.h */
+/* Original 1984: char obuf[BUFSIZ]; */
+char obuf[FRAMEBUFSZ]; /* MODERN: one whole frame, see flush_frame() */
 
 extern const char
     *nomovemsg; /* MODERN: const because assigned string literals */
 extern long wailmsg;
 
-#ifdef CHDIR
+#if defined(CHDIR) && !defined(HACK_BENCH)
 static void chdirx(const char *dir,
                    boolean wr); /* MODERN: const because dir is read-only */
 #endif
 
+#ifndef HACK_BENCH /* MODERN: hack-bench (hack.bench.c) has its own main() */
 int main(int argc, char *argv[]) {
   int fd;
 #ifdef CHDIR
@@ -121,6 +123,31 @@ int main(int argc, char *argv[]) {
   }
 #endif
 
+  /*
+   * MODERN ADDITION (2026): -H[keyfile] plays without a terminal, reading
+   * keystrokes from keyfile or stdin (see hack.termcap.c). It must come
+   * before any option but -d, since the terminal is set up next.
+   */
+  if (argc > 1 && !strncmp(argv[1], "-H", 2)) {
+    headless = TRUE;
+    if (argv[1][2] && !freopen(argv[1] + 2, "r", stdin))
+      error("Cannot read keystrokes from %s.", argv[1] + 2);
+    argc--;
+    argv++;
+  }
+
+  /*
+   * MODERN ADDITION (2026): -j<file> keeps a journal of the game, -r<file>
+   * replays one headless (see hack.journal.c). Same place as -H.
+   */
+  if (argc > 1 && (!strncmp(argv[1], "-j", 2) || !strncmp(argv[1], "-r", 2))) {
+    if (!argv[1][2])
+      error("Flag %s must be followed by a file name.", argv[1]);
+    jr_open(argv[1] + 2, argv[1][1] == 'j' ? JR_RECORD : JR_REPLAY);
+    argc--;
+    argv++;
+  }
+
   /*
    * Who am i? Algorithm: 1. Use name as specified in HACKOPTIONS
    *			2. Use $USER or $LOGNAME	(if 1. fails)
@@ -158,12 +185,22 @@ int main(int argc, char *argv[]) {
     exit(0);
   }
 
+  /* MODERN ADDITION (2026): hack -x writes the top scorers as text 'record' */
+  if (argc > 1 && !strcmp(argv[1], "-x")) {
+#ifdef CHDIR
+    chdirx(dir, 0);
+#endif
+    rec_export();
+    exit(0);
+  }
+
   /*
    * It seems he really wants to play.
    * Remember tty modes, to be restored on exit.
    */
   gettty();
-  setbuf(stdout, obuf);
+  /* Original 1984: setbuf(stdout, obuf); */
+  frame_open(obuf); /* MODERN: see flush_frame() */
   umask(007);
   setrandom();
   startup();
@@ -178,7 +215,8 @@ int main(int argc, char *argv[]) {
   (void)signal(SIGQUIT, hangup);
 #ifdef SIGWINCH
   /* MODERN ADDITION (2025): Terminal resize protection - see handle_resize() */
-  (void)signal(SIGWINCH, handle_resize);
+  if (!headless)
+    (void)signal(SIGWINCH, handle_resize);
   original_CO = CO; /* Store initial terminal size for validation */
   original_LI = LI;
 #endif
@@ -193,7 +231,7 @@ int main(int argc, char *argv[]) {
    * We cannot do chdir earlier, otherwise gethdate will fail.
    */
 #ifdef CHDIR
-  chdirx(dir, 1);
+  chdirx(dir, jr_mode != JR_REPLAY);
 #endif
 
   /*
@@ -262,7 +300,7 @@ int main(int argc, char *argv[]) {
                   /* again if suffix was whole name */
                   /* accepts any suffix */
 #ifdef WIZARD
-  if (!wizard) {
+  if (!wizard && jr_mode != JR_REPLAY) { /* MODERN: a replay locks nothing */
 #endif
     /*
      * check for multiple games under the same name
@@ -288,7 +326,7 @@ int main(int argc, char *argv[]) {
       while (*sfoo) {
         switch (*sfoo++) {
         case 'n':
-          (void)srandom(*sfoo++);
+          rnd_seed((unsigned)*sfoo++);
           break;
         }
       }
@@ -315,12 +353,18 @@ int main(int argc, char *argv[]) {
                  plname); /* MODERN: Safe sprintf replacement - identical
                              output, prevents overflow */
   regularize(SAVEF + 5);  /* avoid . or / in name */
-  if ((fd = open(SAVEF, 0)) >= 0 && (uptodate(fd) || unlink(SAVEF) == 666)) {
+  if (jr_mode == JR_REPLAY) { /* MODERN: files of its own, removed at exit */
+    (void)snprintf(lock, PL_NSIZ + 4, "replay%d", hackpid);
+    (void)snprintf(SAVEF, sizeof(SAVEF), "save/%s", lock);
+  }
+  if (jr_mode != JR_REPLAY && (fd = open(SAVEF, 0)) >= 0 &&
+      (uptodate(fd) || unlink(SAVEF) == 666)) {
     (void)signal(SIGINT, done1);
     pline("Restoring old save file...");
     (void)fflush(stdout);
     if (!dorecover(fd))
       goto not_recovered;
+    jr_restored();
     pline("Hello %s, welcome to %s!", plname, gamename);
     flags.move = 0;
   } else {
@@ -330,6 +374,7 @@ int main(int argc, char *argv[]) {
     ftrap = 0;
     fgold = 0;
     flags.ident = 1;
+    jr_start(); /* MODERN: seed and journal, see hack.journal.c */
     init_objects();
     u_init();
 
@@ -445,6 +490,15 @@ int main(int argc, char *argv[]) {
     /* MODERN ADDITION (2025): Check for pending terminal resize */
     check_resize();
 #endif
+#ifdef ALLOC_STATS
+    check_allocstats(); /* MODERN: SIGUSR1 asked for the report */
+#endif
+
+    /* MODERN: the frame for this turn is complete; when no command is
+     * read (running, counted commands, occupations, helplessness) send it
+     * now, otherwise readchar() does. Replaces the multi % 7 flush below. */
+    if (multi || occupation)
+      flush_frame();
 
     flags.move = 1;
 
@@ -480,10 +534,10 @@ int main(int argc, char *argv[]) {
 #endif
       rhack((char *)0);
     }
-    if (multi && multi % 7 == 0)
-      (void)fflush(stdout);
+    /* Original 1984: if(multi && multi%7 == 0) (void) fflush(stdout); */
   }
 }
+#endif /* HACK_BENCH */
 
 void glo(int foo) {
   /* construct the string  xlock.n  */
@@ -535,7 +589,7 @@ void impossible(const char *s, int x1, int x2) {
   pline("Program in disorder - perhaps you'd better Quit.");
 }
 
-#ifdef CHDIR
+#if defined(CHDIR) && !defined(HACK_BENCH)
 static void chdirx(const char *dir,
                    boolean wr) /* MODERN: const because dir is read-only */
 {
@@ -618,12 +672,13 @@ void handle_resize(int sig) {
 /**
  * MODERN: Check and handle pending terminal resize*/
 void check_resize(void) {
-  if (!resize_pending)
+  if (!resize_pending && !jr_resized())
     return;
 
   /* Query current terminal size */
   int new_CO, new_LI;
   startup(); /* Re-read termcap values */
+  jr_resize(&CO, &LI); /* MODERN: journaled, a replay takes the recorded size */
   new_CO = CO;
   new_LI = LI;
 
@@ -638,13 +693,15 @@ void check_resize(void) {
   if (new_CO < COLNO || new_LI < ROWNO + 2) {
     /* Terminal too small - pause game */
     cls();
+    scr_suspend(); /* MODERN: prompt goes straight to the terminal */
     printf("\n\nTERMINAL TOO SMALL!\n");
     printf("Current: %dx%d, Required: %dx%d\n", new_CO, new_LI, COLNO,
            ROWNO + 2);
     printf("Please resize terminal and press any key...");
-    getchar();
+    (void)jr_getchar();
     /* Re-check after user input */
     startup();
+    jr_resize(&CO, &LI);
     if (CO >= COLNO && LI >= ROWNO + 2) {
       /* Size is now adequate */
       docrt(); /* Full screen redraw */
@@ -653,6 +710,7 @@ void check_resize(void) {
     /* If still too small, will re-prompt on next check */
   } else {
     /* Terminal size acceptable but changed - redraw everything */
+    scr_suspend(); /* MODERN: contents after a resize are unknown */
     docrt();
     pline("[Terminal resized to %dx%d - display refreshed]", new_CO, new_LI);
     resize_pending = 0;
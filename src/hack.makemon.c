@@ -35,7 +35,7 @@ struct monst zeromonst;
  *	In case we make an Orc or killer bee, we make an entire horde (swarm);
  *	note that in this case we return only one of them (the one at [x,y]).
  */
-struct monst *makemon(struct permonst *ptr, int x, int y) {
+static struct monst *makemon1(struct permonst *ptr, int x, int y) {
   struct monst *mtmp;
   int tmp, ct;
   boolean anything = (!ptr);
@@ -77,9 +77,8 @@ gotmon:
   for (ct = 0; ct < (int)ptr->pxlth;
        ct++) /* MODERN: Cast pxlth to int for loop comparison */
     ((char *)&(mtmp->mextra[0]))[ct] = 0;
-  mtmp->nmon = fmon;
-  fmon = mtmp;
-  mtmp->m_id = flags.ident++;
+  mtmp->m_id = flags.ident++; /* MODERN: first, link_monster() files it */
+  link_monster(mtmp); /* MODERN: was mtmp->nmon = fmon, fmon = mtmp */
   mtmp->data = ptr;
   mtmp->mxlth = ptr->pxlth;
   if (ptr->mlet == 'D')
@@ -88,8 +87,7 @@ gotmon:
     mtmp->mhpmax = mtmp->mhp = (schar)rnd(4); /* MODERN: cast to schar */
   else
     mtmp->mhpmax = mtmp->mhp = (schar)d(ptr->mlevel, 8); /* MODERN: cast to schar */
-  mtmp->mx = (xchar)x; /* MODERN: cast to xchar */
-  mtmp->my = (xchar)y; /* MODERN: cast to xchar */
+  place_monster(mtmp, x, y); /* MODERN: was mx = x, my = y; see hack.grid.c */
   mtmp->mcansee = 1;
   if (ptr->mlet == 'M') {
     mtmp->mimic = 1;
@@ -144,6 +142,14 @@ gotmon:
   return (mtmp);
 }
 
+struct monst *makemon(struct permonst *ptr, int x, int y) {
+  int rs = rnd_use(RS_MONST); /* MODERN: own random stream, see rnd.c */
+  struct monst *mtmp = makemon1(ptr, x, y);
+
+  (void)rnd_use(rs);
+  return (mtmp);
+}
+
 coord enexto(xchar xx, xchar yy) {
   xchar x, y;
   coord foo[15], *tfoo;
@@ -205,8 +211,7 @@ void rloc(struct monst *mtmp) {
     tx = rn1(COLNO - 3, 2);
     ty = rn2(ROWNO);
   } while (!goodpos(tx, ty));
-  mtmp->mx = (xchar)tx; /* MODERN: cast to xchar */
-  mtmp->my = (xchar)ty; /* MODERN: cast to xchar */
+  place_monster(mtmp, tx, ty); /* MODERN: was mx = tx, my = ty */
   if (u.ustuck == mtmp) {
     if (u.uswallow) {
       u.ux = (xchar)tx; /* MODERN: cast to xchar */
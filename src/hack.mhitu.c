@@ -8,7 +8,7 @@
  * mhitu: monster hits you
  *	  returns 1 if monster dies (e.g. 'y', 'F'), 0 otherwise
  */
-int mhitu(struct monst *mtmp) {
+static int mhitu1(struct monst *mtmp) {
   struct permonst *mdat = mtmp->data;
   int tmp, ctmp;
 
@@ -117,7 +117,7 @@ int mhitu(struct monst *mtmp) {
       pline("You hear %s's hissing!", monnam(mtmp));
       if (ctmp || !rn2(20) ||
           (flags.moonphase == NEW_MOON && !carrying(DEAD_LIZARD))) {
-        Stoned = 5;
+        set_utimeout(STONED, 5L); /* MODERN: was Stoned = 5 */
         /* pline("You get turned to stone!"); */
         /* done_in_by(mtmp); */
       }
@@ -312,7 +312,7 @@ int mhitu(struct monst *mtmp) {
     mondead(mtmp);
     if (!Blind) {
       pline("You are blinded by a blast of light!");
-      Blind = d(4, 12);
+      set_utimeout(BLIND, (long)d(4, 12)); /* MODERN: was Blind = */
       seeoff(0);
     }
     return (1);
@@ -325,6 +325,14 @@ int mhitu(struct monst *mtmp) {
   return (0);
 }
 
+int mhitu(struct monst *mtmp) {
+  int rs = rnd_use(RS_COMBAT); /* MODERN: own random stream, see rnd.c */
+  int ret = mhitu1(mtmp);
+
+  (void)rnd_use(rs);
+  return (ret);
+}
+
 int hitu(struct monst *mtmp, int dam) {
   int tmp, res;
 
@@ -12,8 +12,9 @@ extern struct monst *makemon();
 extern struct obj *mkobj_at();
 extern struct trap *maketrap();
 
-#define somex() ((random() % (croom->hx - croom->lx + 1)) + croom->lx)
-#define somey() ((random() % (croom->hy - croom->ly + 1)) + croom->ly)
+/* MODERN: rn1() so room spots come from the level stream, see rnd.c */
+#define somex() rn1(croom->hx - croom->lx + 1, croom->lx)
+#define somey() rn1(croom->hy - croom->ly + 1, croom->ly)
 #define XLIM 4 /* define minimum required space around a room */
 #define YLIM 3
 boolean secret; /* TRUE while making a vault: increase [XY]LIM */
@@ -18,10 +18,8 @@ struct obj *mkobj_at(let, x, y)
 int let, x, y;
 {
   struct obj *otmp = mkobj(let);
-  otmp->ox = (xchar)x; /* MODERN: explicit cast to xchar for coordinate */
-  otmp->oy = (xchar)y; /* MODERN: explicit cast to xchar for coordinate */
-  otmp->nobj = fobj;
-  fobj = otmp;
+  obj_link(&fobj, otmp);
+  place_object(otmp, x, y); /* MODERN: sets ox/oy and the occupancy grid */
   return (otmp);
 }
 
@@ -29,22 +27,25 @@ struct obj *mksobj_at(otyp, x, y)
 int otyp, x, y;
 {
   struct obj *otmp = mksobj(otyp);
-  otmp->ox = (xchar)x; /* MODERN: explicit cast to xchar for coordinate */
-  otmp->oy = (xchar)y; /* MODERN: explicit cast to xchar for coordinate */
-  otmp->nobj = fobj;
-  fobj = otmp;
+  obj_link(&fobj, otmp);
+  place_object(otmp, x, y); /* MODERN: sets ox/oy and the occupancy grid */
   return (otmp);
 }
 
 struct obj *mkobj(let)
 int let;
 {
+  struct obj *otmp;
+  int rs = rnd_use(RS_ITEM); /* MODERN: own random stream, see rnd.c */
+
   if (!let)
     let = mkobjstr[rn2(sizeof(mkobjstr) - 1)];
-  return (mksobj(
+  otmp = mksobj(
       letter(let)
           ? CORPSE + ((let > 'Z') ? (let - 'a' + 'Z' - '@' + 1) : (let - '@'))
-          : probtype(let)));
+          : probtype(let));
+  (void)rnd_use(rs);
+  return (otmp);
 }
 
 struct obj zeroobj;
@@ -53,6 +54,7 @@ struct obj *mksobj(otyp)
 int otyp;
 {
   struct obj *otmp;
+  int rs = rnd_use(RS_ITEM); /* MODERN: own random stream, see rnd.c */
   /* MODERN: Add bounds checking for objects array access */
   if (otyp < 0 || otyp >= NROFOBJECTS) {
     impossible("mksobj called with invalid otyp %d", otyp, 0);
@@ -134,6 +136,7 @@ int otyp;
           otyp); /* MODERN: Better error reporting */
   }
   otmp->owt = (uchar)weight(otmp); /* MODERN: cast weight() result to uchar */
+  (void)rnd_use(rs);
   return (otmp);
 }
 
@@ -165,11 +168,9 @@ int x, y;
     gold->amount += amount;
   else {
     gold = newgold();
-    gold->ngold = fgold;
-    gold->gx = (xchar)x; /* MODERN: explicit cast to xchar for coordinate */
-    gold->gy = (xchar)y; /* MODERN: explicit cast to xchar for coordinate */
     gold->amount = amount;
-    fgold = gold;
+    gold_link(gold);
+    place_gold(gold, x, y); /* MODERN: sets gx/gy and the occupancy grid */
     /* do sth with display? */
   }
   return gold; /* MODERN: Return gold pointer - was missing return value */
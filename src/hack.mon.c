@@ -79,24 +79,179 @@ int lastwarnlev;
 const char *const warnings[] = {"white", "pink",   "red",
                                 "ruby",  "purple", "black"};
 
+/*
+ * MODERN ADDITION (2026): Per-turn monster run queue
+ *
+ * WHY: movemon() restarted from fmon after every monster's move to find the
+ * next one with mlstmv < moves, because the monster (or its successor) may
+ * have died and new monsters may have been linked in while it moved. Every
+ * monster that had already moved was stepped over again, so a turn cost
+ * O(n^2) chain steps in the number of monsters.
+ *
+ * HOW: At turn start monq[] takes a snapshot of the monsters in fmon order
+ * that still have to move. Monsters linked into fmon during the turn
+ * (makemon, replmon, losedogs, cutworm - all via link_monster()) go on
+ * monborn[]. Dead monsters stay allocated on fdmon until dmonsfree() at the
+ * end of movemon(), and monfree() marks them as having moved, so a stale
+ * snapshot entry is simply skipped. savelev() empties the queue, because it
+ * frees the monsters the snapshot points at. When the snapshot runs out,
+ * fmon is walked once more and anything still unmoved is queued again.
+ *
+ * PRESERVES: The original picked the first monster in fmon with
+ * mlstmv < moves. Links only ever happen at the head of fmon and unlinking
+ * keeps the order of the rest, so that is the most recently linked unmoved
+ * newcomer, or else the next unmoved snapshot entry - the order used here.
+ * ADDS: O(n) per turn; #stats shows the queue entries examined per move.
+ */
+static struct monst **monq, **monborn;
+static int monqlen, monqpos, monqsz;
+static int bornlen, bornsz;
+static boolean monq_active;
+static long monq_picks, monq_steps;
+
+static struct monst **monq_grow(struct monst **q, int *sz, int need) {
+  if (need <= *sz)
+    return (q);
+  *sz = (need > 2 * *sz) ? need : 2 * *sz;
+  return ((struct monst **)enlarge((char *)q,
+                                   (unsigned)(*sz * sizeof(struct monst *))));
+}
+
+/* snapshot the monsters of fmon that have not moved this turn */
+static int monq_fill(void) {
+  struct monst *mtmp;
+  int n = 0;
+
+  for (mtmp = fmon; mtmp; mtmp = mtmp->nmon)
+    n++;
+  monq = monq_grow(monq, &monqsz, n);
+  monqlen = monqpos = 0;
+  for (mtmp = fmon; mtmp; mtmp = mtmp->nmon)
+    if (mtmp->mlstmv < moves)
+      monq[monqlen++] = mtmp;
+  monq_steps += n;
+  return (monqlen);
+}
+
+#ifdef HACK_BENCH
+int monq_legacy; /* hack-bench: pick monsters the 1984 way */
+
+long monq_steps_total(void) { return (monq_steps); }
+#endif /* HACK_BENCH */
+
+static struct monst *monq_next(void) {
+  struct monst *mtmp;
+
+#ifdef HACK_BENCH
+  if (monq_legacy) {
+    for (mtmp = fmon; mtmp; mtmp = mtmp->nmon) {
+      monq_steps++;
+      if (mtmp->mlstmv < moves)
+        return (mtmp);
+    }
+    return ((struct monst *)0);
+  }
+#endif /* HACK_BENCH */
+  do {
+    while (bornlen) {
+      mtmp = monborn[--bornlen];
+      monq_steps++;
+      if (mtmp->mlstmv < moves)
+        return (mtmp);
+    }
+    while (monqpos < monqlen) {
+      mtmp = monq[monqpos++];
+      monq_steps++;
+      if (mtmp->mlstmv < moves)
+        return (mtmp);
+    }
+  } while (monq_fill());
+  return ((struct monst *)0);
+}
+
+/* the monsters the queue points at are about to be freed */
+void monq_reset(void) {
+  monqlen = monqpos = bornlen = 0;
+}
+
+/* MODERN: see obj_put() */
+static void mon_put(struct monst **head, struct monst **link,
+                    struct monst *mtmp) {
+  if ((mtmp->nmon = *link))
+    LBACK(mtmp->nmon) = (void *)&mtmp->nmon;
+  LHEAD(mtmp) = (void *)head;
+  LBACK(mtmp) = (void *)link;
+  *link = mtmp;
+  id_mon(mtmp); /* see hack.ident.c */
+}
+
+/* MODERN: put mtmp first in the chain at *head; see obj_link() */
+void mon_link(struct monst **head, struct monst *mtmp) {
+  mon_put(head, head, mtmp);
+}
+
+/* put mtmp right after pred, in pred's chain */
+void mon_after(struct monst *pred, struct monst *mtmp) {
+  mon_put((struct monst **)LHEAD(pred), &pred->nmon, mtmp);
+}
+
+/* the chain starting at *head was built or moved by hand; see obj_head() */
+void mon_head(struct monst **head) {
+  struct monst **link;
+
+  for (link = head; *link; link = &(*link)->nmon) {
+    LHEAD(*link) = (void *)head;
+    LBACK(*link) = (void *)link;
+  }
+}
+
+/* take mtmp out of the chain at *head; FALSE if it is not there */
+boolean mon_unlink(struct monst **head, struct monst *mtmp) {
+  struct monst **link = (struct monst **)LBACK(mtmp);
+
+  if (LHEAD(mtmp) != (void *)head) /* in another chain, or in none */
+    return (FALSE);
+  if (!link || *link != mtmp) {
+    impossible("mon_unlink: stale back-link", 0, 0);
+    return (FALSE);
+  }
+  if ((*link = mtmp->nmon))
+    LBACK(mtmp->nmon) = (void *)link;
+  LHEAD(mtmp) = LBACK(mtmp) = 0;
+  return (TRUE);
+}
+
+/* put mtmp at the head of fmon */
+void link_monster(struct monst *mtmp) {
+  mon_link(&fmon, mtmp);
+  if (monq_active) {
+    monborn = monq_grow(monborn, &bornsz, bornlen + 1);
+    monborn[bornlen++] = mtmp;
+  }
+}
+
+void prmonqstats(void) {
+  pline("Monsters: %ld moves, %ld queue steps (%ld per move).", monq_picks,
+        monq_steps, monq_steps / (monq_picks ? monq_picks : 1));
+}
+
 void movemon(void) {
   struct monst *mtmp;
   int fr;
+  int rs = rnd_use(RS_MONST); /* MODERN: own random stream, see rnd.c */
 
   warnlevel = 0;
+  monq_reset();
+  monq_active = 1;
 
   while (1) {
     /* find a monster that we haven't treated yet */
-    /* note that mtmp or mtmp->nmon might get killed
-       while mtmp moves, so we cannot just walk down the
-       chain (even new monsters might get created!) */
-    for (mtmp = fmon; mtmp; mtmp = mtmp->nmon)
-      if (mtmp->mlstmv < moves)
-        goto next_mon;
-    /* treated all monsters */
-    break;
+    /* MODERN: was a rescan from fmon for mlstmv < moves; the run queue
+       gives the same monster (see above) */
+    if (!(mtmp = monq_next()))
+      break; /* treated all monsters */
+    monq_picks++;
 
-  next_mon:
     mtmp->mlstmv = moves;
 
     /* most monsters drown in pools */
@@ -172,15 +327,17 @@ void movemon(void) {
       lastwarnlev = warnlevel;
     }
 
+  monq_active = 0;
+  monq_reset();
   dmonsfree(); /* remove all dead monsters */
+  (void)rnd_use(rs);
 }
 
 void justswld(struct monst *mtmp,
               const char *name) /* MODERN: const because name is read-only */
 {
 
-  mtmp->mx = u.ux;
-  mtmp->my = u.uy;
+  place_monster(mtmp, u.ux, u.uy); /* MODERN: was mx = u.ux, my = u.uy */
   u.ustuck = mtmp;
   pmon(mtmp);
   kludge("%s swallows you!", name);
@@ -377,7 +534,7 @@ int m_move(struct monst *mtmp, int after) {
       pline("You are getting more and more confused.");
     if (rn2(3))
       mtmp->mcan = 1;
-    Confusion += d(3, 4); /* timeout */
+    incr_utimeout(CONFUSION, (long)d(3, 4)); /* MODERN: was += */
   }
 not_special:
   if (!mtmp->mflee && u.uswallow && u.ustuck != mtmp)
@@ -494,8 +651,7 @@ not_special:
       (void)hitu(mtmp, d(mtmp->data->damn, mtmp->data->damd) + 1);
       return (0);
     }
-    mtmp->mx = nix;
-    mtmp->my = niy;
+    place_monster(mtmp, nix, niy); /* MODERN: was mx = nix, my = niy */
     for (j = MTSZ - 1; j > 0; j--)
       mtmp->mtrack[j] = mtmp->mtrack[j - 1];
     mtmp->mtrack[0].x = omx;
@@ -690,8 +846,9 @@ void mondead(struct monst *mtmp) {
 void replmon(struct monst *mtmp, struct monst *mtmp2) {
   relmon(mtmp);
   monfree(mtmp);
-  mtmp2->nmon = fmon;
-  fmon = mtmp2;
+  link_monster(mtmp2); /* MODERN: was mtmp2->nmon = fmon, fmon = mtmp2 */
+  obj_head(&mtmp2->minvent); /* MODERN: its inventory moved with the copy */
+  place_monster(mtmp2, mtmp2->mx, mtmp2->my); /* MODERN: occupancy grid */
   if (u.ustuck == mtmp)
     u.ustuck = mtmp2;
   if (mtmp2->isshk)
@@ -701,15 +858,9 @@ void replmon(struct monst *mtmp, struct monst *mtmp2) {
 }
 
 void relmon(struct monst *mon) {
-  struct monst *mtmp;
-
-  if (mon == fmon)
-    fmon = fmon->nmon;
-  else {
-    for (mtmp = fmon; mtmp->nmon != mon; mtmp = mtmp->nmon)
-      ;
-    mtmp->nmon = mon->nmon;
-  }
+  remove_monster(mon); /* MODERN: off the occupancy grid */
+  if (!mon_unlink(&fmon, mon)) /* MODERN: O(1), see obj_link() */
+    panic("relmon");
 }
 
 /* we do not free monsters immediately, in order to have their name
@@ -717,6 +868,8 @@ void relmon(struct monst *mon) {
 struct monst *fdmon; /* chain of dead monsters, need not to be saved */
 
 void monfree(struct monst *mtmp) {
+  mtmp->mlstmv = moves; /* MODERN: the run queue skips it from now on */
+  LHEAD(mtmp) = LBACK(mtmp) = 0; /* MODERN: fdmon is only walked */
   mtmp->nmon = fdmon;
   fdmon = mtmp;
 }
@@ -725,7 +878,7 @@ void dmonsfree(void) {
   struct monst *mtmp;
   while ((mtmp = fdmon)) {
     fdmon = mtmp->nmon;
-    free((char *)mtmp);
+    lfree((char *)mtmp);
   }
 }
 
@@ -946,8 +1099,7 @@ void mnexto(
 {
   coord mm;
   mm = enexto(u.ux, u.uy);
-  mtmp->mx = mm.x;
-  mtmp->my = mm.y;
+  place_monster(mtmp, mm.x, mm.y); /* MODERN: was mx = mm.x, my = mm.y */
   pmon(mtmp);
 }
 
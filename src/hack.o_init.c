@@ -22,7 +22,9 @@ extern void error(const char *s, ...);
 /* MODERN: CONST-CORRECTNESS: panic message is read-only */
 extern void panic(const char *str, ...);
 extern int rn2(int x);
+#ifndef ALLOC_STATS /* MODERN: see config.h */
 extern void *alloc(unsigned lth);
+#endif
 /* MODERN: CONST-CORRECTNESS: cornline text is read-only */
 extern void cornline(int mode, const char *text);
 /* MODERN: CONST-CORRECTNESS: pline message is read-only */
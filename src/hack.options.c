@@ -187,6 +187,24 @@ void parseoptions(char *opts, boolean from_env) {
     }
     return;
   }
+
+  /* MODERN: levelcache:<KB> - memory kept for levels left behind */
+  if (!strncmp(opts, "levelcache", 5)) {
+    if (negated) {
+      levcache_kb = 0; /* every level goes to its file at once */
+      return;
+    }
+    op = index(opts, ':');
+    if (!op || !digit(op[1]))
+      goto bad;
+    num = atoi(op + 1);
+    if (num > 9999) {
+      pline("Option value too large (max 9999): %u", num);
+      goto bad;
+    }
+    levcache_kb = num;
+    return;
+  }
 bad:
   if (!from_env) {
     if (!strncmp(opts, "help", 4)) {
@@ -202,6 +220,8 @@ bad:
             "These can be negated by prefixing them with '!' or \"no\".");
       pline("%s",
             "A string option is name, as in HACKOPTIONS=\"name:Merlin-W\".");
+      pline("%s",
+            "A numeric option is levelcache, as in \"levelcache:512\" (KB).");
       pline(
           "%s%s%s",
           "A compound option is endgame; it is followed by a description of "
@@ -285,6 +305,13 @@ int doset(void) {
         remaining -= added;
       }
     }
+    if (levcache_kb != LEVCACHE_KB && remaining > 0) {
+      int added = snprintf(buf + len, remaining, "levelcache:%ld,", levcache_kb);
+      if (added > 0 && added < remaining) {
+        len += added;
+        remaining -= added;
+      }
+    }
     if ((flags.end_top != 5 || flags.end_around != 4 || flags.end_own) &&
         remaining > 0) {
       int added =
@@ -186,7 +186,7 @@ int page_line(const char *s) /* returns 1 if we should quit */
   if (cury == LI - 1) {
     if (!*s)
       return (0); /* suppress blank lines at top */
-    putchar('\n');
+    scr_putc('\n'); /* MODERN: was putchar('\n'); */
     cury++;
     cmore("q\033");
     if (morc) {
@@ -200,7 +200,8 @@ int page_line(const char *s) /* returns 1 if we should quit */
       cl_eos();
     }
   }
-  puts(s);
+  scr_puts(s); /* MODERN: was puts(s); */
+  scr_putc('\n');
   cury++;
   return (0);
 }
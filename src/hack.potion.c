@@ -33,7 +33,7 @@ int dodrink(void) {
   case POT_BOOZE:
     unkn++;
     pline("Ooph!  This tastes like liquid fire!");
-    Confusion += d(3, 8);
+    incr_utimeout(CONFUSION, (long)d(3, 8)); /* MODERN: was += */
     /* the whiskey makes us feel better */
     if (u.uhp < u.uhpmax)
       losehp(-1, "bottle of whiskey");
@@ -53,7 +53,7 @@ int dodrink(void) {
         pline("You feel rather airy."), unkn++;
       newsym(u.ux, u.uy);
     }
-    Invis += rn1(15, 31);
+    incr_utimeout(INVIS, (long)rn1(15, 31)); /* MODERN: was += */
     break;
   case POT_FRUIT_JUICE:
     pline("This tastes like fruit juice.");
@@ -66,7 +66,7 @@ int dodrink(void) {
     if (u.uhp > u.uhpmax)
       u.uhp = ++u.uhpmax;
     if (Blind)
-      Blind = 1; /* see on next move */
+      set_utimeout(BLIND, 1L); /* see on next move */
     if (Sick)
       Sick = 0;
     break;
@@ -124,7 +124,7 @@ int dodrink(void) {
       pline("Huh, What?  Where am I?");
     else
       nothing++;
-    Confusion += rn1(7, 16);
+    incr_utimeout(CONFUSION, (long)rn1(7, 16)); /* MODERN: was += */
     break;
   case POT_GAIN_STRENGTH:
     pline("Wow do you feel strong!");
@@ -151,14 +151,14 @@ int dodrink(void) {
       pline("You are suddenly moving much faster.");
     else
       pline("Your legs get new energy."), unkn++;
-    Fast += rn1(10, 100);
+    incr_utimeout(FAST, (long)rn1(10, 100)); /* MODERN: was += */
     break;
   case POT_BLINDNESS:
     if (!Blind)
       pline("A cloud of darkness falls upon you.");
     else
       nothing++;
-    Blind += rn1(100, 250);
+    incr_utimeout(BLIND, (long)rn1(100, 250)); /* MODERN: was += */
     seeoff(0);
     break;
   case POT_GAIN_LEVEL:
@@ -171,7 +171,7 @@ int dodrink(void) {
     if (u.uhp > u.uhpmax)
       u.uhp = (u.uhpmax += 2);
     if (Blind)
-      Blind = 1;
+      set_utimeout(BLIND, 1L); /* MODERN: was Blind = 1 */
     if (Sick)
       Sick = 0;
     break;
@@ -180,7 +180,7 @@ int dodrink(void) {
       float_up();
     else
       nothing++;
-    Levitation += rnd(100);
+    incr_utimeout(PROP(RIN_LEVITATION), (long)rnd(100)); /* MODERN: was += */
     u.uprops[PROP(RIN_LEVITATION)].p_tofn = float_down;
     break;
   default:
@@ -326,7 +326,7 @@ void potionbreathe(struct obj *obj) {
   case POT_BOOZE:
     if (!Confusion)
       pline("You feel somewhat dizzy.");
-    Confusion += rnd(5);
+    incr_utimeout(CONFUSION, (long)rnd(5)); /* MODERN: was += */
     break;
   case POT_INVISIBILITY:
     pline("For an instant you couldn't see your right hand.");
@@ -336,13 +336,13 @@ void potionbreathe(struct obj *obj) {
     nomul(-rnd(5));
     break;
   case POT_SPEED:
-    Fast += rnd(5);
+    incr_utimeout(FAST, (long)rnd(5)); /* MODERN: was += */
     pline("Your knees seem more flexible now.");
     break;
   case POT_BLINDNESS:
     if (!Blind)
       pline("It suddenly gets dark.");
-    Blind += rnd(5);
+    incr_utimeout(BLIND, (long)rnd(5)); /* MODERN: was += */
     seeoff(0);
     break;
     /*
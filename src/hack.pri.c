@@ -21,13 +21,13 @@ void swallowed(void) {
 
   cls();
   curs(u.ux - 1, u.uy + 1);
-  fputs("/-\\", stdout);
+  scr_puts("/-\\"); /* MODERN: was fputs(..., stdout); see hack.screen.c */
   curx = u.ux + 2;
   curs(u.ux - 1, u.uy + 2);
-  fputs(ulook, stdout);
+  scr_puts(ulook);
   curx = u.ux + 2;
   curs(u.ux - 1, u.uy + 3);
-  fputs("\\-/", stdout);
+  scr_puts("\\-/");
   curx = u.ux + 2;
   u.udispl = 1;
   u.udisx = u.ux;
@@ -44,6 +44,7 @@ __attribute__((noreturn))
 panic(const char *str, ...) {
   if (panicking++)
     exit(1); /* avoid loops - this should never happen*/
+  scr_suspend(); /* MODERN: the message goes straight to the terminal */
   home();
   puts(" Suddenly, the dungeon collapses.");
   fputs(" ERROR:  ", stdout);
@@ -119,7 +120,8 @@ void tmp_at(schar x, schar y) {
     return;
   }
   if (prevx >= 0 && cansee(prevx, prevy)) {
-    delay_output(50);
+    if (!headless) /* MODERN: scripted games run at CPU speed */
+      delay_output(50);
     prl(prevx, prevy); /* in case there was a monster */
     at(prevx, prevy,
        levl[(int)prevx][(int)prevy]
@@ -170,7 +172,7 @@ void Tmp_at(schar x, schar y) { /* MODERN: Keep original schar to preserve -1,-2
   }
   /* normal call */
   if (cansee(x, y)) {
-    if (cnt)
+    if (cnt && !headless) /* MODERN: scripted games run at CPU speed */
       delay_output(50);
     at(x, y, let);
     tc[(int)cnt].x =
@@ -203,7 +205,7 @@ void at(xchar x, xchar y, char ch) {
   }
   y += 2;
   curs(x, y);
-  (void)putchar(ch);
+  scr_putc(ch); /* MODERN: was (void) putchar(ch); */
   curx++;
 }
 
@@ -213,6 +215,7 @@ void prme(void) {
 }
 
 int doredraw(void) {
+  scr_suspend(); /* MODERN: ^R repaints everything, not just the difference */
   docrt();
   return (0);
 }
@@ -710,7 +713,7 @@ void bot(void) {
   for (i = 1; i < COLNO; i++) {
     if (*ob != *nb) {
       curs(i, ROWNO + 2);
-      (void)putchar(*nb ? *nb : ' ');
+      scr_putc(*nb ? *nb : ' '); /* MODERN: was (void) putchar() */
       curx++;
     }
     if (*ob)
@@ -93,7 +93,7 @@ int doread(void) {
   case SCR_CONFUSE_MONSTER:
     if (confused) {
       pline("Your hands begin to glow purple.");
-      Confusion += rnd(100);
+      incr_utimeout(CONFUSION, (long)rnd(100)); /* MODERN: was += */
     } else {
       pline("Your hands begin to glow blue.");
       u.umconf = 1;
@@ -138,7 +138,7 @@ int doread(void) {
       Punished = 0;
       freeobj(uchain);
       unpobj(uchain);
-      free((char *)uchain);
+      lfree((char *)uchain);
       uball->spe = 0;
       uball->owornmask &= ~W_BALL;
       uchain = uball = (struct obj *)0;
@@ -0,0 +1,477 @@
+/* hack.record.c - Indexed store for the list of top scorers
+ *
+ * MODERN ADDITION (2026): Keeps the top scorers in an append-only data file
+ * and a small rank index instead of the one text file 'record'.
+ *
+ * WHY: topten() held the record lock while it fscanf()ed every line of
+ * 'record' and then rewrote the whole file through fopen(recfile, "w") - a
+ * crash or a full disk in the middle of that rewrite lost the list. prscore()
+ * re-parsed the same text on every 'hack -s'. Every other game ending at the
+ * same time waited for the lock through all of it.
+ *
+ * HOW: Entries live as fixed-size binary records in the data file
+ * "record.d<epoch>" and are never rewritten; a new score is appended at the
+ * end. "record.idx" holds a header and the file offsets of the listed
+ * entries in rank order, so ranking is a binary search over the index and
+ * publishing a new list writes one record plus the index.
+ *
+ * rec_score() reads the index and ranks the new entry without any lock,
+ * appends it (O_APPEND, so concurrent writers never share an offset) and
+ * writes the new index to a private file, all synced. Only then does it take
+ * the record lock, check that the index still carries the generation it
+ * ranked against, and rename its file over "record.idx" - readers see the
+ * old list or the new one, never half of either. If another game published
+ * in between, the new list is built again from the newer index; after
+ * REC_RETRIES lost races the whole update runs under the lock.
+ *
+ * Once the data file outgrows REC_COMPACT records, the publish copies the
+ * live entries into the next epoch's file under the lock and removes the
+ * old one.
+ *
+ * PRESERVES: The text 'record' is imported on the first game that ends
+ * without an index, and 'hack -x' writes the list back out in that same
+ * format. Ranking rules (PERSMAX, POINTSMIN, ENTRYMAX) stay in ttmerge().
+ * ADDS: Crash-safe updates, parse-free score listing, and a record lock
+ * held for a rename instead of a parse and rewrite.
+ */
+
+#include "hack.h"
+#include "def.topten.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+/* MODERN ADDITION (2025): Added for stale lock detection - stat() and time() */
+#include <sys/stat.h>
+#include <time.h>
+
+/* Store file names - relative to hackdir after chdir() */
+#define REC_INDEX "record.idx"
+#define REC_DATA "record.d%u"
+#define REC_LOCK "record_lock" /* Original 1984 link() lock */
+#define REC_MAGIC 0x52485332   /* "RHS2" */
+#define REC_COMPACT (4 * ENTRYMAX)
+#define REC_RETRIES 5
+#define REC_STALE (-4) /* another game published first */
+
+#define HUP if (!done_hup)
+
+/* One entry in the data file */
+struct screc {
+  long points;
+  int level, maxlvl, hp, maxhp;
+  int uid;
+  char plchar;
+  char sex;
+  char name[NAMSZ + 1];
+  char death[DTHSZ + 1];
+  char date[7];
+};
+
+/* Head of the index file, followed by cnt data file offsets */
+struct schdr {
+  unsigned magic;
+  unsigned gen;   /* bumped by every publish */
+  unsigned epoch; /* names the data file */
+  unsigned cnt;   /* listed entries */
+};
+
+struct recstats recstats;
+
+static struct schdr hdr;        /* index the last rec_load() read */
+static unsigned slot[ENTRYMAX]; /* its offsets */
+static boolean rec_locked;
+static long rec_lockedat;
+
+static long rec_usec(void) {
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((long)ts.tv_sec * 1000000L + ts.tv_nsec / 1000);
+}
+
+static int rec_lock(void) {
+  long t = rec_usec();
+#ifndef ENABLE_MODERN_LOCKING
+  int sleepct = 300;
+
+  /**
+   * MODERN ADDITION (2025): Stale lock detection and cleanup
+   *
+   * WHY: Original 1984 code could leave stale record_lock files if the game
+   * crashed or was killed before proper cleanup, causing infinite loops in
+   * subsequent runs waiting for lock release.
+   *
+   * HOW: Check if record_lock exists and is older than 5 minutes (300 seconds).
+   * If so, assume it's stale from a crashed process and remove it
+   * automatically. Uses stat() to get file modification time and compare with
+   * current time.
+   *
+   * PRESERVES: Original Unix file locking semantics using link() for atomicity
+   * ADDS: Defensive programming against stale resources
+   */
+  struct stat lockstat;
+
+  if (stat(REC_LOCK, &lockstat) == 0) {
+    time_t now = time(NULL);
+    if (now - lockstat.st_mtime > 300) { /* 5 minutes */
+      HUP printf("Removing stale record lock (age: %ld seconds)\n",
+                 (long)(now - lockstat.st_mtime));
+      (void)unlink(REC_LOCK);
+    }
+  }
+
+  /* Original 1984 link()-based record locking */
+  while (link(RECORD, REC_LOCK) == -1) {
+    HUP perror(REC_LOCK);
+    if (!sleepct--) {
+      HUP puts("I give up. Sorry.");
+      HUP puts("Perhaps there is an old record_lock around?");
+      recstats.lockfails++;
+      return 0;
+    }
+    HUP printf("Waiting for access to record file. (%d)\n", sleepct);
+    HUP(void) fflush(stdout);
+    sleep(1);
+  }
+#else
+  /* MODERN ADDITION (2025): Use flock()-based record locking */
+  if (!modern_lock_record()) {
+    recstats.lockfails++;
+    return 0;
+  }
+#endif
+  rec_lockedat = rec_usec();
+  t = rec_lockedat - t;
+  recstats.waitus += t;
+  if (t > recstats.maxwaitus)
+    recstats.maxwaitus = t;
+  recstats.locks++;
+  rec_locked = TRUE;
+  return 1;
+}
+
+static void rec_unlock(void) {
+  long t;
+
+  if (!rec_locked)
+    return;
+#ifdef ENABLE_MODERN_LOCKING
+  modern_unlock_record();
+#else
+  (void)unlink(REC_LOCK);
+#endif
+  rec_locked = FALSE;
+  t = rec_usec() - rec_lockedat;
+  recstats.holdus += t;
+  if (t > recstats.maxholdus)
+    recstats.maxholdus = t;
+}
+
+static int rec_open(unsigned epoch, int flags) {
+  char name[32];
+  snprintf(name, sizeof(name), REC_DATA, epoch);
+  return open(name, flags, FMASK);
+}
+
+static void rec_remove(unsigned epoch) {
+  char name[32];
+  snprintf(name, sizeof(name), REC_DATA, epoch);
+  (void)unlink(name);
+}
+
+/* 1: index read into *h (and s), 0: there is no index yet, -1: unreadable */
+static int rec_readidx(struct schdr *h, unsigned *s) {
+  int fd;
+  ssize_t len;
+
+  memset(h, 0, sizeof(*h));
+  if ((fd = open(REC_INDEX, O_RDONLY)) < 0)
+    return (errno == ENOENT) ? 0 : -1;
+  if (read(fd, h, sizeof(*h)) != sizeof(*h) || h->magic != REC_MAGIC ||
+      h->cnt > ENTRYMAX) {
+    (void)close(fd);
+    return -1;
+  }
+  len = (ssize_t)(h->cnt * sizeof(s[0]));
+  if (s && read(fd, s, len) != len) {
+    (void)close(fd);
+    return -1;
+  }
+  (void)close(fd);
+  return 1;
+}
+
+static int rec_writeidx(const char *name, struct schdr *h, unsigned *s) {
+  ssize_t len = (ssize_t)(h->cnt * sizeof(s[0]));
+  int fd;
+
+  if ((fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, FMASK)) < 0)
+    return 0;
+  if (write(fd, h, sizeof(*h)) != sizeof(*h) || write(fd, s, len) != len ||
+      fsync(fd) < 0) {
+    (void)close(fd);
+    (void)unlink(name);
+    return 0;
+  }
+  (void)close(fd);
+  return 1;
+}
+
+static void rec_pack(struct screc *r, struct toptenentry *t) {
+  memset(r, 0, sizeof(*r));
+  r->points = t->points;
+  r->level = t->level;
+  r->maxlvl = t->maxlvl;
+  r->hp = t->hp;
+  r->maxhp = t->maxhp;
+  r->uid = t->uid;
+  r->plchar = t->plchar;
+  r->sex = t->sex;
+  memcpy(r->name, t->name, sizeof(r->name));
+  memcpy(r->death, t->death, sizeof(r->death));
+  memcpy(r->date, t->date, sizeof(r->date));
+}
+
+/* Read the 1984 text record - only while no index exists */
+static int rec_import(struct toptenentry **ents) {
+  static struct toptenentry t;
+  FILE *rfile;
+  int n = 0;
+
+  if (!(rfile = fopen(RECORD, "r")))
+    return -1;
+  while (n < ENTRYMAX &&
+         fscanf(rfile, "%6s %d %d %d %d %d %ld %c%c %64[^,],%128[^\n]", t.date,
+                &t.uid, &t.level, &t.maxlvl, &t.hp, &t.maxhp, &t.points,
+                &t.plchar, &t.sex, t.name, t.death) == 11 &&
+         t.points >= POINTSMIN) {
+    ents[n] = newttentry();
+    *ents[n] = t;
+    ents[n]->tt_next = 0;
+    ents[n++]->recno = -1;
+  }
+  (void)fclose(rfile);
+  return n;
+}
+
+/*
+ * Fill ents[] with the listed entries in rank order, taken from the arena.
+ * Returns how many there are, or -1 if the list cannot be read.
+ */
+int rec_load(struct toptenentry **ents) {
+  struct screc r;
+  struct toptenentry *t;
+  unsigned i;
+  int fd, tries;
+
+  for (tries = 0; tries < 3; tries++) {
+    switch (rec_readidx(&hdr, slot)) {
+    case -1:
+      return -1;
+    case 0:
+      return rec_import(ents);
+    }
+    if (!hdr.cnt)
+      return 0;
+    /* a concurrent compaction may remove the file the index we read named */
+    if ((fd = rec_open(hdr.epoch, O_RDONLY)) < 0) {
+      if (errno == ENOENT)
+        continue;
+      return -1;
+    }
+    for (i = 0; i < hdr.cnt; i++) {
+      if (pread(fd, &r, sizeof(r), (off_t)slot[i]) != sizeof(r)) {
+        (void)close(fd);
+        return -1;
+      }
+      t = ents[i] = newttentry();
+      t->tt_next = 0;
+      t->points = r.points;
+      t->level = r.level;
+      t->maxlvl = r.maxlvl;
+      t->hp = r.hp;
+      t->maxhp = r.maxhp;
+      t->uid = r.uid;
+      t->plchar = r.plchar;
+      t->sex = r.sex;
+      memcpy(t->name, r.name, sizeof(t->name));
+      t->name[NAMSZ] = 0;
+      memcpy(t->death, r.death, sizeof(t->death));
+      t->death[DTHSZ] = 0;
+      memcpy(t->date, r.date, sizeof(t->date));
+      t->date[sizeof(t->date) - 1] = 0;
+      t->recno = (int)slot[i];
+    }
+    (void)close(fd);
+    return (int)hdr.cnt;
+  }
+  return -1;
+}
+
+/* Under the lock: copy the list into the next epoch's data file */
+static int rec_compact(struct toptenentry **ents, int n, struct schdr *nhdr,
+                       unsigned *nslot) {
+  struct screc r;
+  int fd, i;
+
+  nhdr->epoch = hdr.epoch + 1;
+  if ((fd = rec_open(nhdr->epoch, O_WRONLY | O_CREAT | O_TRUNC)) < 0)
+    return 0;
+  for (i = 0; i < n; i++) {
+    rec_pack(&r, ents[i]);
+    nslot[i] = (unsigned)(i * sizeof(r));
+    if (write(fd, &r, sizeof(r)) != sizeof(r)) {
+      (void)close(fd);
+      return 0;
+    }
+  }
+  if (fsync(fd) < 0) {
+    (void)close(fd);
+    return 0;
+  }
+  (void)close(fd);
+  return 1;
+}
+
+/*
+ * Make ents[0..n-1], built from the last rec_load(), the new list.
+ * Returns 0, REC_STALE if another game published since that load, or
+ * REC_NOLOCK/REC_NOWRITE with the old list left in place. Leaves the
+ * record lock released.
+ */
+static int rec_publish(struct toptenentry **ents, int n) {
+  static unsigned nslot[ENTRYMAX];
+  struct schdr nhdr, cur;
+  struct screc r;
+  char tmp[32];
+  off_t end = 0;
+  int fd = -1, i;
+
+  /* outside the lock: append the new entries, write the index aside */
+  for (i = 0; i < n; i++) {
+    if (ents[i]->recno >= 0) {
+      nslot[i] = (unsigned)ents[i]->recno;
+      continue;
+    }
+    if (fd < 0 &&
+        (fd = rec_open(hdr.epoch, O_WRONLY | O_CREAT | O_APPEND)) < 0)
+      goto fail;
+    rec_pack(&r, ents[i]);
+    if (write(fd, &r, sizeof(r)) != sizeof(r) ||
+        (end = lseek(fd, (off_t)0, SEEK_CUR)) < 0) {
+      (void)close(fd);
+      goto fail;
+    }
+    nslot[i] = (unsigned)(end - sizeof(r));
+    ents[i]->recno = (int)nslot[i];
+  }
+  if (fd >= 0) {
+    if (fsync(fd) < 0) {
+      (void)close(fd);
+      goto fail;
+    }
+    (void)close(fd);
+  }
+  nhdr.magic = REC_MAGIC;
+  nhdr.gen = hdr.gen + 1;
+  nhdr.epoch = hdr.epoch;
+  nhdr.cnt = n;
+  snprintf(tmp, sizeof(tmp), REC_INDEX ".%d", getpid());
+  if (!rec_writeidx(tmp, &nhdr, nslot))
+    goto fail;
+
+  /* the lock covers the generation check and the rename */
+  if (!rec_locked && !rec_lock()) {
+    (void)unlink(tmp);
+    return REC_NOLOCK;
+  }
+  if (rec_readidx(&cur, (unsigned *)0) < 0 || cur.gen != hdr.gen) {
+    rec_unlock();
+    (void)unlink(tmp);
+    /* our append may have recreated a data file compacted away meanwhile */
+    if (end > 0 && cur.gen && cur.epoch != hdr.epoch)
+      rec_remove(hdr.epoch);
+    return REC_STALE;
+  }
+  if (end > (off_t)(REC_COMPACT * sizeof(r)) &&
+      (!rec_compact(ents, n, &nhdr, nslot) ||
+       !rec_writeidx(tmp, &nhdr, nslot))) {
+    rec_remove(hdr.epoch + 1);
+    (void)unlink(tmp);
+    goto fail;
+  }
+  if (rename(tmp, REC_INDEX) < 0) {
+    (void)unlink(tmp);
+    goto fail;
+  }
+  rec_unlock();
+  recstats.publishes++;
+
+  if (nhdr.epoch != hdr.epoch)
+    rec_remove(hdr.epoch);
+  for (i = 0; i < n; i++)
+    ents[i]->recno = (int)nslot[i];
+  hdr = nhdr;
+  memcpy(slot, nslot, n * sizeof(slot[0]));
+  return 0;
+
+fail:
+  rec_unlock();
+  return REC_NOWRITE;
+}
+
+/*
+ * Rank t0 against the current list and publish the result. list[] gets the
+ * new list and the return value its length, or REC_NOREAD, REC_NOLOCK or
+ * REC_NOWRITE. rank0 and rank1 are as ttmerge() leaves them. With 'hold'
+ * the record lock is held from reading the list to publishing it.
+ */
+int rec_score(struct toptenentry *t0, struct toptenentry **list, int *rank0,
+              int *rank1, boolean hold) {
+  struct toptenentry *ents[ENTRYMAX];
+  int n, m, flg, tries, ret;
+  unsigned epoch;
+
+  t0->recno = -1;
+  for (tries = 0;; tries++) {
+    /* after REC_RETRIES lost races, take the lock so this game gets its turn */
+    if ((hold || tries >= REC_RETRIES) && !rec_locked && !rec_lock())
+      return REC_NOLOCK;
+    reset_topten_arena();
+    epoch = hdr.epoch;
+    if ((n = rec_load(ents)) < 0) {
+      rec_unlock();
+      return REC_NOREAD;
+    }
+    /* what a lost race appended stays good while its data file is current */
+    if (hdr.epoch != epoch)
+      t0->recno = -1;
+    m = ttmerge(ents, n, t0, list, rank0, rank1, &flg);
+    if (!flg) {
+      rec_unlock();
+      return m;
+    }
+    if ((ret = rec_publish(list, m)) != REC_STALE)
+      return ret ? ret : m;
+    recstats.retries++;
+  }
+}
+
+/* hack -x: write the list in the 1984 text format */
+void rec_export(void) {
+  struct toptenentry *ents[ENTRYMAX], *t1;
+  int n, i;
+
+  reset_topten_arena();
+  if ((n = rec_load(ents)) < 0) {
+    puts("Cannot open record file!");
+    return;
+  }
+  for (i = 0; i < n; i++) {
+    t1 = ents[i];
+    printf("%6s %d %d %d %d %d %ld %c%c %s,%s\n", t1->date, t1->uid,
+           t1->level, t1->maxlvl, t1->hp, t1->maxhp, t1->points, t1->plchar,
+           t1->sex, t1->name, t1->death);
+  }
+}
@@ -83,7 +83,7 @@ void outrip(void) {
         if (done_stopprint)
           return;
         curx++;
-        (void)putchar(dpx[x++]);
+        scr_putc(dpx[x++]); /* MODERN: was (void) putchar() */
       }
     }
   }
@@ -5,6 +5,7 @@
 #include "hack.h"
 extern char genocided[60]; /* defined in Decl.c */
 extern char fut_geno[60];  /* idem */
+#include <errno.h>
 #include <fcntl.h>
 #include <signal.h>
 #include <stdint.h>
@@ -30,7 +31,7 @@ typedef struct {
   char magic[4];      /* "RHCK" */
   uint16_t version;   /* Format version, currently 1 */
   uint32_t endiantag; /* 0x01020304 for endian detection */
-  uint32_t reserved;  /* For future use */
+  uint32_t seed;      /* Game seed (version 4; was reserved, 0) */
 } rh_hdr_t;
 
 /* Save format version history:
@@ -41,9 +42,15 @@ typedef struct {
  *                   - Added: usick_cause as object type index
  *                   - Added: p_tofn as function ID
  *                   - Struct dump now has pointers zeroed before save
+ * Version 3 (2026): Level images copied whole from the level files
+ *                   - Added: image length after each level number
+ * Version 4 (2026): Levels are made from the game seed, see rnd_level()
+ *                   - Added: game seed in the header's reserved word
+ * Version 5 (2026): Level images in the portable format of hack.levimg.c
+ *                   - Images of versions 3 and 4 still load
  */
 #define RH_MAGIC "RHCK"
-#define RH_VERSION 2
+#define RH_VERSION 5
 #define RH_ENDIANTAG 0x01020304
 
 /* Fixed-width type definitions for save format */
@@ -205,13 +212,13 @@ static int write_save_header(int fd) {
   memcpy(hdr.magic, RH_MAGIC, 4);
   hdr.version = RH_VERSION;
   hdr.endiantag = RH_ENDIANTAG;
-  hdr.reserved = 0;
+  hdr.seed = rnd_game();
 
   /* Write header using our serialization functions for consistency */
   sw_bytes(fd, hdr.magic, 4);
   sw_u16(fd, hdr.version);
   sw_u32(fd, hdr.endiantag);
-  sw_u32(fd, hdr.reserved);
+  sw_u32(fd, hdr.seed);
 
   return 1;
 }
@@ -231,14 +238,14 @@ static int check_save_header(int fd, rh_hdr_t *hdr) {
 
   hdr->version = sr_u16(fd);
   hdr->endiantag = sr_u32(fd);
-  hdr->reserved = sr_u32(fd);
+  hdr->seed = sr_u32(fd);
 
   /* Check endianness */
   if (hdr->endiantag != RH_ENDIANTAG) {
     return 0; /* Different endianness not supported yet */
   }
 
-  /* Accept versions 1 through RH_VERSION (currently 2) */
+  /* Accept versions 1 through RH_VERSION (currently 5) */
   if (hdr->version < 1 || hdr->version > RH_VERSION) {
     return 0; /* Unsupported version */
   }
@@ -288,8 +295,8 @@ static int (*restore_timeout_fn(rh_u32_t id))(void) {
 
 extern char SAVEF[], nul[];
 extern char pl_character[PL_CSIZ];
-extern struct obj *restobjchn(int fd);
-extern struct monst *restmonchn(int fd);
+extern void restobjchn(int fd, struct obj **head);
+extern void restmonchn(int fd, struct monst **head);
 extern int dosave0(int hu);
 extern void savenames(int fd);
 extern void restnames(int fd);
@@ -321,7 +328,10 @@ int dosave(void) {
  * ADDS: Modern signal compatibility for Hyprland/Wayland window closure
  */
 void modern_save_handler(int sig) {
-  (void)sig;
+  /* MODERN: before the first level is made, or between two levels, the
+     level globals hold no level to save; getlev() would refuse it */
+  if (u.ux == FAR)
+    modern_cleanup_handler(sig);
   /* Attempt to save game state before cleanup */
   (void)dosave0(1);
   exit(1);
@@ -332,7 +342,7 @@ void hangup(int sig) { modern_save_handler(sig); }
 
 /* returns 1 if save successful */
 int dosave0(int hu) {
-  int fd, ofd;
+  int fd;
   int tmp; /* not ! */
   char tmpfile[256];
 
@@ -347,6 +357,7 @@ int dosave0(int hu) {
     (void)unlink(tmpfile);
     return (0);
   }
+  bufon(fd); /* MODERN: the save file is written in one go, see bufoff() */
   if (flags.moonphase == FULL_MOON) /* ut-sally!fletcher */
     u.uluck--;                      /* and unido!ab */
   savelev(fd, dlevel);
@@ -377,6 +388,7 @@ int dosave0(int hu) {
       save_u.uprops[i].p_tofn = NULL;
     }
   }
+  utimeout_counts(save_u.uprops); /* MODERN: turns left, as always */
 
   sw_u32(fd, (rh_u32_t)sizeof(struct you));
   sw_bytes(fd, &save_u, sizeof(struct you));
@@ -435,26 +447,31 @@ int dosave0(int hu) {
   sw_bytes(fd, fut_geno, sizeof fut_geno);
   savenames(fd);
   for (tmp = 1; tmp <= maxdlevel; tmp++) {
-    extern int hackpid;
     extern boolean level_exists[];
 
     if (tmp == dlevel || !level_exists[tmp])
       continue;
     glo(tmp);
-    if ((ofd = open(lock, 0)) < 0) {
+    bwrite(fd, (char *)&tmp, sizeof tmp); /* level number */
+    /* MODERN: the level file as it is, behind its length (version 3) */
+    if (!savelevimg(fd, tmp)) {
       if (!hu)
         pline("Error while saving: cannot read %s.", lock);
+      (void)bufoff(fd);
       (void)close(fd);
       (void)unlink(tmpfile);
       if (!hu)
         done("tricked");
       return (0);
     }
-    getlev(ofd, hackpid, tmp);
-    (void)close(ofd);
-    bwrite(fd, (char *)&tmp, sizeof tmp); /* level number */
-    savelev(fd, tmp);                     /* actual level */
-    (void)unlink(lock);
+  }
+
+  if (bufoff(fd) < 0) {
+    if (!hu)
+      pline("Error writing save file: %s.", strerror(errno));
+    (void)close(fd);
+    (void)unlink(tmpfile);
+    return (0);
   }
 
   /* Ensure data is written to disk before atomic rename */
@@ -478,6 +495,15 @@ int dosave0(int hu) {
     return (0);
   }
 
+  /* MODERN: the level files go only once the save file holds them */
+  for (tmp = 1; tmp <= maxdlevel; tmp++) {
+    extern boolean level_exists[];
+
+    if (tmp == dlevel || !level_exists[tmp])
+      continue;
+    glo(tmp);
+    (void)unlink(lock);
+  }
   glo(dlevel);
   (void)unlink(lock); /* get rid of current level --jgm */
   glo(0);
@@ -496,12 +522,12 @@ int dorecover(int fd) {
 
   restoring = TRUE;
   getlev(fd, 0, 0);
-  invent = restobjchn(fd);
+  restobjchn(fd, &invent);
   for (otmp = invent; otmp; otmp = otmp->nobj)
     if (otmp->owornmask)
       setworn(otmp, otmp->owornmask);
-  fcobj = restobjchn(fd);
-  fallen_down = restmonchn(fd);
+  restobjchn(fd, &fcobj);
+  restmonchn(fd, &fallen_down);
 
   /* Check if this is a versioned save file */
   rh_hdr_t hdr;
@@ -524,6 +550,8 @@ int dorecover(int fd) {
     dlevel = sr_i32(fd);
     maxdlevel = sr_i32(fd);
     moves = (long)sr_u32(fd);
+    if (hdr.version >= 4) /* MODERN: levels still to come use the old seed */
+      rnd_setgame(hdr.seed);
 
     /* Read struct you */
     rh_u32_t you_size = sr_u32(fd);
@@ -566,7 +594,7 @@ int dorecover(int fd) {
         }
       }
 
-    } else if (hdr.version == 2) {
+    } else if (hdr.version >= 2 && hdr.version <= 5) {
       /* Version 2: Safe pointer serialization */
 
       /* Restore usick_cause from object index */
@@ -600,6 +628,8 @@ int dorecover(int fd) {
       return (0);
     }
 
+    utimeouts_restored(); /* MODERN: the timer queue is not saved */
+
     /* Read remaining common fields */
     sr_bytes(fd, pl_character, sizeof pl_character);
     sr_bytes(fd, genocided, sizeof genocided);
@@ -622,16 +652,24 @@ int dorecover(int fd) {
     return (0);
   }
   restnames(fd);
-  while (1) {
-    if (read(fd, (char *)&tmp, sizeof tmp) != sizeof tmp)
-      break;
-    getlev(fd, 0, tmp);
-    glo(tmp);
-    if ((nfd = creat(lock, FMASK)) < 0)
-      panic("Cannot open temp file %s!\n", lock);
-    savelev(nfd, tmp);
-    (void)close(nfd);
+  if (hdr.version >= 3) {
+    restlevfiles(fd); /* MODERN: level images back into their level files */
+  } else {
+    while (1) {
+      if (read(fd, (char *)&tmp, sizeof tmp) != sizeof tmp)
+        break;
+      getlev(fd, 0, tmp);
+      glo(tmp);
+      if ((nfd = creat(lock, FMASK)) < 0)
+        panic("Cannot open temp file %s!\n", lock);
+      bufon(nfd);
+      savelev(nfd, tmp);
+      if (bufoff(nfd) < 0)
+        panic("Cannot write level file %s: %s", lock, strerror(errno));
+      (void)close(nfd);
+    }
   }
+  id_level(FALSE); /* MODERN: the copy read first is left behind, unfiled */
   (void)lseek(fd, (off_t)0, 0);
   getlev(fd, 0, 0);
   (void)close(fd);
@@ -668,21 +706,10 @@ int dorecover(int fd) {
    * since u.ustuck from struct dump may contain garbage. */
   u.ustuck = NULL; /* Clear garbage pointer from struct dump */
   if (has_ustuck) {
-    struct monst *mtmp;
-    int found = 0;
-
-    for (mtmp = fmon; mtmp; mtmp = mtmp->nmon) {
-      if (mtmp->m_id == mid) {
-        u.ustuck = mtmp;
-        found = 1;
-        break;
-      }
-    }
-
-    if (!found) {
+    /* MODERN: O(1) through the id index, see hack.ident.c */
+    if (!(u.ustuck = mon_by_id(mid))) {
       /* Don't panic - just unstick player gracefully */
       pline("Warning: Save file inconsistency (ustuck) - monster not found.");
-      u.ustuck = NULL;
     }
   }
 
@@ -699,17 +726,15 @@ int dorecover(int fd) {
   return (1);
 }
 
-struct obj *restobjchn(int fd) {
-  struct obj *otmp, *otmp2;
-  struct obj *first = 0;
+/* MODERN: links what it reads into the chain at *head, see obj_link() */
+void restobjchn(int fd, struct obj **head) {
+  struct obj *otmp, *otmp2 = 0;
+  struct obj *more = 0;
   int xl;
 #ifndef MAXONAMELTH
 #define MAXONAMELTH 63 /* Max for 6-bit onamelth field */
 #endif
-#ifdef lint
-  /* suppress "used before set" warning from lint */
-  otmp2 = 0;
-#endif /* lint */
+  *head = 0;
   while (1) {
     mread(fd, (char *)&xl, sizeof(xl));
     if (xl == -1)
@@ -720,11 +745,8 @@ struct obj *restobjchn(int fd) {
     }
     /* MODERN: Allocate extra byte for NUL terminator */
     otmp = newobj(xl > 0 ? xl + 1 : xl);
-    if (!first)
-      first = otmp;
-    else
-      otmp2->nobj = otmp;
     mread(fd, (char *)otmp, (unsigned)xl + sizeof(struct obj));
+    more = otmp->nobj; /* as saved: set on all but the last */
     /* MODERN: Normalize onamelth to match allocation and ensure null-terminated
      */
     otmp->onamelth = (xl > 0) ? xl : 0;
@@ -733,18 +755,20 @@ struct obj *restobjchn(int fd) {
     }
     if (!otmp->o_id)
       otmp->o_id = flags.ident++;
+    if (otmp2)
+      obj_after(otmp2, otmp);
+    else
+      obj_link(head, otmp);
     otmp2 = otmp;
   }
-  if (first && otmp2->nobj) {
+  if (more)
     impossible("Restobjchn: error reading objchn.", 0, 0);
-    otmp2->nobj = 0;
-  }
-  return (first);
 }
 
-struct monst *restmonchn(int fd) {
-  struct monst *mtmp, *mtmp2;
-  struct monst *first = 0;
+/* MODERN: links what it reads into the chain at *head, see mon_link() */
+void restmonchn(int fd, struct monst **head) {
+  struct monst *mtmp, *mtmp2 = 0;
+  struct monst *more = 0;
   int xl;
 
   struct permonst *monbegin;
@@ -753,30 +777,25 @@ struct monst *restmonchn(int fd) {
   mread(fd, (char *)&monbegin, sizeof(monbegin));
   differ = (char *)(&mons[0]) - (char *)(monbegin);
 
-#ifdef lint
-  /* suppress "used before set" warning from lint */
-  mtmp2 = 0;
-#endif /* lint */
+  *head = 0;
   while (1) {
     mread(fd, (char *)&xl, sizeof(xl));
     if (xl == -1)
       break;
     mtmp = newmonst(xl);
-    if (!first)
-      first = mtmp;
-    else
-      mtmp2->nmon = mtmp;
     mread(fd, (char *)mtmp, (unsigned)xl + sizeof(struct monst));
+    more = mtmp->nmon; /* as saved: set on all but the last */
     if (!mtmp->m_id)
       mtmp->m_id = flags.ident++;
+    if (mtmp2)
+      mon_after(mtmp2, mtmp);
+    else
+      mon_link(head, mtmp);
     mtmp->data = (struct permonst *)((char *)mtmp->data + differ);
     if (mtmp->minvent)
-      mtmp->minvent = restobjchn(fd);
+      restobjchn(fd, &mtmp->minvent);
     mtmp2 = mtmp;
   }
-  if (first && mtmp2->nmon) {
+  if (more)
     impossible("Restmonchn: error reading monchn.", 0, 0);
-    mtmp2->nmon = 0;
-  }
-  return (first);
 }
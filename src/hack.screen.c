@@ -0,0 +1,341 @@
+/* hack.screen.c - Shadow screen and difference renderer for restoHack
+ *
+ * MODERN ADDITION (2026): Replaces drawing straight to the terminal with
+ * drawing into an in-memory copy of the screen.
+ *
+ * WHY: Every docrt() cleared the terminal and repainted the whole map, the
+ * top line and the status line, although a level change or a closed pager
+ * window usually leaves most of the screen as it was. On slow links that
+ * full repaint is the bulk of everything the game sends.
+ *
+ * HOW: While a session is active (between start_screen() and end_screen())
+ * the termcap primitives - curs(), home(), cl_end(), cl_eos(),
+ * clear_screen(), standoutbeg()/standoutend() - and the character writers
+ * at(), bot(), putsym(), swallowed(), page_line() and outrip() only update
+ * the wanted screen, want[]. scr_render(), called from flush_frame(),
+ * compares it with have[], what the terminal shows, and sends only the
+ * changed cells, reached by curs() (which may retype cells it reads back
+ * with scr_peek()), and clear-to-EOL for line tails that became blank. A
+ * real clear is sent when that is cheaper or when the terminal contents
+ * are unknown.
+ *
+ * Code that must write to the terminal directly (panic(), the "terminal too
+ * small" prompt) calls scr_suspend(); the model then stays out of the way
+ * until the next clear_screen() re-establishes a known screen.
+ *
+ * In headless mode (see hack.termcap.c) want[] is never rendered; it is
+ * the screen model, and scr_text() prints it as text.
+ *
+ * PRESERVES: What the player sees; curx/cury keep their 1984 meaning (the
+ * position the game believes it has drawn to).
+ * ADDS: Redraws cost the difference, not the screen.
+ */
+
+#include "hack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern xchar curx, cury;
+extern char *CL, *CE;
+extern int CO, LI;
+
+/* a cell is a character plus the standout bit */
+typedef unsigned short scell;
+#define SC_SO 0x100
+#define SC_BLANK ((scell)' ')
+
+boolean scr_shadow; /* drawing goes to want[] */
+
+static boolean scr_session;  /* between start_screen() and end_screen() */
+static boolean painting;     /* inside scr_render() */
+static boolean have_valid;   /* have[] matches the terminal */
+static boolean scr_dirty;    /* want[] written since the last render */
+static scell *want, *have;   /* rows x cols, row-major */
+static int rows, cols;
+static int vx, vy;           /* model cursor, 1-based like curx/cury */
+static scell vattr;          /* current standout bit */
+static int px, py;           /* terminal cursor; px == 0: unknown */
+static scell pattr;          /* terminal standout state */
+static int cl_cost, ce_cost; /* bytes sent by CL and CE */
+
+static long cells_put, cells_sent, full_clears, renders;
+
+static void fill(scell *p, int n) {
+  while (n-- > 0)
+    *p++ = SC_BLANK;
+}
+
+/* size the model to the terminal; contents become blank */
+static void scr_alloc(void) {
+  if (!want || rows != LI || cols != CO) {
+    if (want) {
+      free(want);
+      free(have);
+    }
+    rows = LI;
+    cols = CO;
+    want = (scell *)alloc((unsigned)(rows * cols * sizeof(scell)));
+    have = (scell *)alloc((unsigned)(rows * cols * sizeof(scell)));
+  }
+  fill(want, rows * cols);
+  fill(have, rows * cols);
+  cl_cost = xcost(CL);
+  ce_cost = xcost(CE);
+}
+
+void scr_start(void) {
+  scr_session = TRUE;
+  scr_shadow = FALSE; /* until clear_screen() gives us a known screen */
+  have_valid = FALSE;
+}
+
+void scr_end(void) {
+  if (scr_shadow)
+    scr_render();
+  scr_shadow = FALSE;
+  scr_session = FALSE;
+}
+
+/* the terminal is about to be written directly */
+void scr_suspend(void) {
+  if (scr_shadow)
+    scr_render();
+  scr_shadow = FALSE;
+  have_valid = FALSE;
+}
+
+/* clear_screen() has just sent CL: start shadowing a blank screen */
+void scr_resume(void) {
+  if (!scr_session)
+    return;
+  scr_alloc();
+  have_valid = TRUE;
+  scr_dirty = FALSE;
+  vx = vy = px = py = 1;
+  vattr = pattr = 0;
+  scr_shadow = TRUE;
+}
+
+void scr_clear(void) {
+  fill(want, rows * cols);
+  vx = vy = 1;
+  scr_dirty = TRUE;
+}
+
+void scr_goto(int x, int y) {
+  vx = x;
+  vy = y;
+}
+
+void scr_standout(int on) { vattr = on ? SC_SO : 0; }
+
+void scr_putc(int c) {
+  if (!scr_shadow) {
+    (void)putchar(c);
+    return;
+  }
+  switch (c) {
+  case '\n':
+    vx = 1;
+    if (vy < rows)
+      vy++;
+    return;
+  case '\r':
+    vx = 1;
+    return;
+  case '\b':
+    vx--;
+    return;
+  case '\007':
+    (void)putchar(c);
+    return;
+  }
+  if (vx >= 1 && vx <= cols && vy >= 1 && vy <= rows) {
+    want[(vy - 1) * cols + vx - 1] = (scell)((c & 0xff) | vattr);
+    scr_dirty = TRUE;
+    cells_put++;
+  }
+  vx++;
+}
+
+void scr_puts(const char *s) {
+  while (*s)
+    scr_putc(*s++);
+}
+
+void scr_clreol(void) {
+  if (vy >= 1 && vy <= rows && vx <= cols) {
+    int x = vx < 1 ? 1 : vx;
+
+    fill(want + (vy - 1) * cols + x - 1, cols - x + 1);
+    scr_dirty = TRUE;
+  }
+}
+
+void scr_clreos(void) {
+  int y = vy;
+
+  scr_clreol();
+  while (++y <= rows) {
+    fill(want + (y - 1) * cols, cols);
+    scr_dirty = TRUE;
+  }
+}
+
+/* send the terminal cursor to (x,y) with the ordinary cursor routines */
+static void tmove(int x, int y) {
+  if (px == x && py == y)
+    return;
+  if (px == 0) { /* after writing the last column: position unknown */
+    home();
+  } else {
+    curx = (xchar)px;
+    cury = (xchar)py;
+  }
+  curs(x, y);
+  px = curx;
+  py = cury;
+}
+
+static void tattr(scell a) {
+  if (a == pattr)
+    return;
+  if (a)
+    standoutbeg();
+  else
+    standoutend();
+  pattr = a;
+}
+
+static void tputcell(scell *h, scell w, int x) {
+  tattr(w & SC_SO);
+  (void)xputc(w & 0xff);
+  *h = w;
+  cells_sent++;
+  px = (x == cols) ? 0 : x + 1;
+}
+
+/* Is clearing the whole terminal and painting want[] cheaper than the
+   difference? Both sides count one byte per cell and ignore motion. */
+static boolean clear_cheaper(void) {
+  int i, n = rows * cols, diff = 0, paint = cl_cost;
+
+  for (i = 0; i < n; i++) {
+    if (want[i] != have[i])
+      diff++;
+    if (want[i] != SC_BLANK)
+      paint++;
+  }
+  return (boolean)(paint < diff);
+}
+
+static void render_row(int r) {
+  scell *w = want + r * cols, *h = have + r * cols;
+  int wl, hl, end, i, y = r + 1;
+
+  if (!memcmp(w, h, cols * sizeof(scell)))
+    return;
+  for (wl = cols - 1; wl >= 0 && w[wl] == SC_BLANK; wl--)
+    ;
+  for (hl = cols - 1; hl >= 0 && h[hl] == SC_BLANK; hl--)
+    ;
+  end = cols;
+  if (ce_cost && hl > wl && hl - wl > ce_cost)
+    end = wl + 1; /* the tail goes with one CE */
+  for (i = 0; i < end; i++) {
+    if (w[i] == h[i])
+      continue;
+    if (y == rows && i == cols - 1)
+      continue; /* writing the last cell may scroll */
+    tmove(i + 1, y); /* curs() may retype cells on the way */
+    tputcell(h + i, w[i], i + 1);
+  }
+  if (end < cols) {
+    tmove(end + 1, y);
+    tattr(0);
+    xputs(CE);
+    fill(h + end, cols - end);
+  }
+}
+
+void scr_render(void) {
+  int lx = curx, ly = cury, r;
+
+  if (!scr_shadow)
+    return;
+  if (headless) { /* want[] is all there is */
+    scr_dirty = FALSE;
+    return;
+  }
+  scr_shadow = FALSE; /* the primitives drive the terminal while we paint */
+  painting = TRUE;
+  if (scr_dirty) {
+    renders++;
+    if (!have_valid || clear_cheaper()) {
+      tattr(0);
+      xputs(CL);
+      fill(have, rows * cols);
+      have_valid = TRUE;
+      px = py = 1;
+      full_clears++;
+    }
+    for (r = 0; r < rows; r++)
+      render_row(r);
+    tattr(0);
+    scr_dirty = FALSE;
+  }
+  tmove(lx, ly);
+  curx = (xchar)lx;
+  cury = (xchar)ly;
+  painting = FALSE;
+  scr_shadow = TRUE;
+}
+
+/* the character the terminal shows at (x,y), if retyping it is harmless:
+   known, in the current standout state, and not in the last column */
+int scr_peek(int x, int y) {
+  scell c;
+
+  if (!painting || x < 1 || x >= cols || y < 1 || y > rows)
+    return -1;
+  c = have[(y - 1) * cols + x - 1];
+  if ((c & SC_SO) != pattr)
+    return -1;
+  return c & 0xff;
+}
+
+/* headless: the screen as text, trailing blanks and standout dropped */
+void scr_text(void) {
+  int r, x, end;
+
+  if (!scr_shadow)
+    return;
+  for (r = 0; r < rows; r++) {
+    for (end = cols; end > 0 && want[r * cols + end - 1] == SC_BLANK; end--)
+      ;
+    for (x = 0; x < end; x++)
+      (void)putchar(want[r * cols + x] & 0xff);
+    (void)putchar('\n');
+  }
+}
+
+/* FNV-1a of the screen model, for the replay checks in hack.journal.c */
+unsigned scr_hash(void) {
+  unsigned h = 2166136261u;
+  int i, n;
+
+  if (!scr_shadow)
+    return 0;
+  n = rows * cols;
+  for (i = 0; i < n; i++) {
+    h ^= want[i];
+    h *= 16777619u;
+  }
+  return h ^ (unsigned)n;
+}
+
+void prscrstats(void) {
+  pline("Screen: %ld renders, %ld cells drawn, %ld sent, %ld full clears.",
+        renders, cells_put, cells_sent, full_clears);
+}
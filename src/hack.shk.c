@@ -7,7 +7,7 @@
 int shlevel = 0;
 struct monst *shopkeeper = 0;
 struct obj *billobjs = 0;
-void obfree(struct obj *obj, struct obj *merge) { free((char *)obj); }
+void obfree(struct obj *obj, struct obj *merge) { lfree((char *)obj); }
 int inshop(void) { return (0); }
 void shopdig(void) {}
 void addtobill(void) {}
@@ -111,7 +111,7 @@ static void setpaid(void) { /* caller has checked that shopkeeper exists */
       obj->unpaid = 0;
   while ((obj = billobjs)) {
     billobjs = obj->nobj;
-    free((char *)obj);
+    lfree((char *)obj);
   }
   ESHK(shopkeeper)->billct = 0;
 }
@@ -262,8 +262,7 @@ void obfree(struct obj *obj, struct obj *merge) {
     if (!merge) {
       bp->useup = 1;
       obj->unpaid = 0; /* only for doinvbill */
-      obj->nobj = billobjs;
-      billobjs = obj;
+      obj_link(&billobjs, obj);
       return;
     }
     bpm = onbill(merge);
@@ -278,7 +277,7 @@ void obfree(struct obj *obj, struct obj *merge) {
       *bp = bill[ESHK(shopkeeper)->billct];
     }
   }
-  free((char *)obj);
+  lfree((char *)obj);
 }
 
 static void pay(long tmp, struct monst *shkp) {
@@ -437,18 +436,9 @@ static int dopayobj(struct bill_x *bp) {
   pay(ltmp, shopkeeper);
   pline("You bought %s for %ld gold piece%s.", doname(obj), ltmp, plur(ltmp));
   if (bp->useup) {
-    struct obj *otmp = billobjs;
-    if (obj == billobjs)
-      billobjs = obj->nobj;
-    else {
-      while (otmp && otmp->nobj != obj)
-        otmp = otmp->nobj;
-      if (otmp)
-        otmp->nobj = obj->nobj;
-      else
-        pline("Error in shopkeeper administration.");
-    }
-    free((char *)obj);
+    if (!obj_unlink(&billobjs, obj))
+      pline("Error in shopkeeper administration.");
+    lfree((char *)obj);
   }
   return (1);
 }
@@ -472,24 +462,12 @@ void paybill(void) {
 }
 
 /* find obj on one of the lists */
-struct obj *bp_to_obj(struct bill_x *bp) {
-  struct obj *obj;
-  struct monst *mtmp;
-  unsigned id = bp->bo_id;
-
-  if (bp->useup)
-    obj = o_on(id, billobjs);
-  else if (!(obj = o_on(id, invent)) && !(obj = o_on(id, fobj)) &&
-           !(obj = o_on(id, fcobj))) {
-    for (mtmp = fmon; mtmp; mtmp = mtmp->nmon)
-      if ((obj = o_on(id, mtmp->minvent)))
-        break;
-    for (mtmp = fallen_down; mtmp; mtmp = mtmp->nmon)
-      if ((obj = o_on(id, mtmp->minvent)))
-        break;
-  }
-  return (obj);
-}
+/*
+ * MODERN: one lookup in the id index, see hack.ident.c; was o_on() over
+ * billobjs for a used-up entry, else over invent, fobj, fcobj and the
+ * inventory of every monster on the level and in fallen_down.
+ */
+struct obj *bp_to_obj(struct bill_x *bp) { return (obj_by_id(bp->bo_id)); }
 
 static int getprice();
 
@@ -565,8 +543,7 @@ void subfrombill(struct obj *obj) {
       otmp->owt = 0; /* superfluous */
       otmp->onamelth = 0;
       bp->useup = 1;
-      otmp->nobj = billobjs;
-      billobjs = otmp;
+      obj_link(&billobjs, otmp);
       return;
     }
     ESHK(shopkeeper)->billct--;
@@ -759,8 +736,7 @@ int shkcatch(struct obj *obj) {
       shkp->mx == ESHK(shkp)->shk.x && shkp->my == ESHK(shkp)->shk.y &&
       u.ux == ESHK(shkp)->shd.x && u.uy == ESHK(shkp)->shd.y) {
     pline("%s nimbly catches the %s.", Monnam(shkp), xname(obj));
-    obj->nobj = shkp->minvent;
-    shkp->minvent = obj;
+    obj_link(&shkp->minvent, obj);
     return (1);
   }
   return (0);
@@ -916,8 +892,7 @@ int shk_move(struct monst *shkp) {
       (void)hitu(shkp, d(mdat->damn, mdat->damd) + 1);
       return (0);
     }
-    shkp->mx = nix;
-    shkp->my = niy;
+    place_monster(shkp, nix, niy); /* MODERN: was mx = nix, my = niy */
     pmon(shkp);
     if (ib) {
       freeobj(ib);
@@ -944,8 +919,7 @@ void shopdig(int fall) {
       if (obj->owornmask)
         continue;
       freeinv(obj);
-      obj->nobj = shopkeeper->minvent;
-      shopkeeper->minvent = obj;
+      obj_link(&shopkeeper->minvent, obj);
       if (obj->unpaid)
         subfrombill(obj);
     }
@@ -142,7 +142,7 @@ struct obj *steal(struct monst *mtmp) {
   if (Punished && otmp == uball) {
     Punished = 0;
     freeobj(uchain);
-    free((char *)uchain);
+    lfree((char *)uchain);
     uchain = (struct obj *)0;
     uball->spe = 0;
     uball = (struct obj *)0; /* superfluous */
@@ -154,8 +154,7 @@ struct obj *steal(struct monst *mtmp) {
 }
 
 void mpickobj(struct monst *mtmp, struct obj *otmp) {
-  otmp->nobj = mtmp->minvent;
-  mtmp->minvent = otmp;
+  obj_link(&mtmp->minvent, otmp);
 }
 
 int stealamulet(struct monst *mtmp) {
@@ -177,19 +176,16 @@ int stealamulet(struct monst *mtmp) {
 
 /* release the objects the killed animal has stolen */
 void relobj(struct monst *mtmp, int show) {
-  struct obj *otmp, *otmp2;
+  struct obj *otmp;
 
-  for (otmp = mtmp->minvent; otmp; otmp = otmp2) {
-    otmp->ox = mtmp->mx;
-    otmp->oy = mtmp->my;
-    otmp2 = otmp->nobj;
-    otmp->nobj = fobj;
-    fobj = otmp;
+  while ((otmp = mtmp->minvent)) {
+    (void)obj_unlink(&mtmp->minvent, otmp); /* MODERN: see obj_link() */
+    obj_link(&fobj, otmp);
+    place_object(otmp, mtmp->mx, mtmp->my); /* MODERN: was otmp->ox/oy = */
     stackobj(fobj);
     if (show & cansee(mtmp->mx, mtmp->my))
       atl(otmp->ox, otmp->oy, otmp->olet);
   }
-  mtmp->minvent = (struct obj *)0;
   if (mtmp->mgold || mtmp->data->mlet == 'L') {
     long tmp;
 
@@ -2,28 +2,66 @@
 /* hack.termcap.c - version 1.0.3 */
 /* $FreeBSD$ */
 
+#define _GNU_SOURCE /* MODERN: fopencookie(), see frame_open() */
 #include "hack.h" /* for function prototypes - includes def.flag.h */
 #include "generated/config.h"
 #include <curses.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <termcap.h>
 #include <unistd.h>
 
 static char tbuf[512];
-static char *HO, *CL, *CE, *hack_UP, *CM, *ND, *XD, *hack_BC, *SO, *SE, *TI,
-    *TE;
+static char *HO, *hack_UP, *CM, *ND, *XD, *hack_BC, *SO, *SE, *TI, *TE;
+char *CL, *CE; /* MODERN: costed by the shadow screen in screen.c */
 static char *VS, *VE;
 static int SG;
 static char hack_PC = '\0';
+static void tcosts(void);
 char *CD;   /* tested in pri.c: docorner() */
 int CO, LI; /* used in pri.c and whatis.c */
 
+/**
+ * MODERN ADDITION (2026): Headless engine mode
+ *
+ * WHY: Everything the game shows goes through termcap sequences and
+ * everything it reads through a terminal in cbreak mode, so a scripted game
+ * needs a pty and runs at the pace pexpect can match its output - a few
+ * keystrokes per second in dev/game_runner.py.
+ *
+ * HOW: 'hack -H' sets headless before gettty(). startup() then skips the
+ * termcap lookup and takes an 80x24 screen whose capabilities are empty
+ * strings, xputs() and xcost() send and price nothing, and gettty(),
+ * settty(), setftty() and setctty() leave the terminal modes alone. Drawing
+ * still goes to the shadow screen (hack.screen.c), which is never rendered:
+ * it is the screen model, and settty() prints it as plain text, so a
+ * scripted game ends with its last screen on stdout. Keystrokes are read
+ * from stdin, or from the file named in -H<file>. The 50 ms animation
+ * delays and the bell are skipped.
+ *
+ * PRESERVES: The game itself - the same keys give the same game as on a
+ * terminal.
+ * ADDS: Scripted games at CPU speed, without a pty.
+ */
+boolean headless;
+
 void startup(void) {
   char *term;
   char *tptr;
   char *tbufptr, *pc;
 
+  if (headless) {
+    static char none[] = "";
+
+    HO = hack_UP = CM = ND = XD = hack_BC = SO = SE = TI = TE = none;
+    CL = CE = CD = VS = VE = none;
+    CO = COLNO;
+    LI = ROWNO + 2;
+    jr_termsize(&CO, &LI); /* a replay has the recorded size */
+    set_whole_screen();
+    return;
+  }
   tptr = (char *)alloc(1024);
 
   tbufptr = tbuf;
@@ -73,6 +111,7 @@ void startup(void) {
     SO = SE = 0;
   CD = tgetstr("cd", &tbufptr);
   set_whole_screen(); /* uses LI and CD */
+  tcosts();           /* MODERN: motion costs for curs() */
   if ((size_t)(tbufptr - tbuf) > sizeof(tbuf))
     error("TERMCAP entry too big...\n"); /* MODERN: Cast pointer diff to size_t
                                             for size comparison */
@@ -82,9 +121,12 @@ void startup(void) {
 void start_screen(void) {
   xputs(TI);
   xputs(VS);
+  tcosts();    /* MODERN: after gettty(): padding depends on ospeed */
+  scr_start(); /* MODERN: shadow screen, see hack.screen.c */
 }
 
 void end_screen(void) {
+  scr_end(); /* MODERN: send what is still pending */
   xputs(VE);
   xputs(TE);
 }
@@ -92,6 +134,164 @@ void end_screen(void) {
 /* Cursor movements */
 extern xchar curx, cury;
 
+/**
+ * MODERN ADDITION (2026): Cost-based cursor motion
+ *
+ * WHY: curs() picked a motion by fixed thresholds ("within 3 columns: move
+ * relatively"), which ignores what the sequences cost: on a vt100 a cm is
+ * eight bytes plus padding while a character already on the screen can be
+ * retyped for one.
+ *
+ * HOW: start_screen() measures every capability with tputs() - padding
+ * included. curs() prices each way of getting there - cm; up/xd/newline
+ * then left or right; carriage return first; home first - and sends the
+ * cheapest. A newline costs two bytes, since the tty driver sends it as
+ * CR LF, and is only used when the driver does that (tty_crmod()). Moving
+ * right retypes the character under the cursor whenever the shadow screen
+ * knows it (scr_peek()), nd otherwise.
+ *
+ * PRESERVES: nocmov() and cmov(); the cursor ends where it always did.
+ * ADDS: Fewest-bytes motion and a count of motion bytes for #stats.
+ */
+#define NOWAY 10000 /* cost of a motion the terminal cannot do */
+
+static int c_HO, c_UP, c_BC, c_ND, c_XD;
+static long mv_count, mv_bytes;
+
+static int tcount;
+
+static int countc(int c) {
+  tcount++;
+  return c;
+}
+
+/* bytes tputs() sends for s, padding included; 0 if absent */
+int xcost(char *s) {
+  if (!s || headless)
+    return 0;
+  tcount = 0;
+  tputs(s, 1, countc);
+  return tcount;
+}
+
+static void tcosts(void) {
+  c_HO = HO ? xcost(HO) : NOWAY;
+  c_UP = hack_UP ? xcost(hack_UP) : NOWAY;
+  c_BC = xcost(hack_BC);
+  c_ND = ND ? xcost(ND) : NOWAY;
+  c_XD = XD ? xcost(XD) : NOWAY;
+}
+
+static int vcost(int fy, int ty) {
+  if (fy > ty)
+    return (fy - ty) * c_UP;
+  return (ty - fy) * c_XD;
+}
+
+static int hcost(int fx, int tx, int y) {
+  int n = 0;
+
+  if (fx > tx)
+    return (fx - tx) * c_BC;
+  for (; fx < tx; fx++)
+    n += (scr_peek(fx, y) >= 0) ? 1 : c_ND;
+  return n;
+}
+
+static void vmove(int y) {
+  while (cury > y) {
+    xputs(hack_UP);
+    cury--;
+  }
+  while (cury < y) {
+    xputs(XD);
+    cury++;
+  }
+}
+
+static void hmove(int x) {
+  int c;
+
+  while (curx > x) {
+    xputs(hack_BC);
+    curx--;
+  }
+  while (curx < x) {
+    if ((c = scr_peek(curx, cury)) >= 0)
+      (void)xputc(c);
+    else
+      xputs(ND);
+    curx++;
+  }
+}
+
+void curs(int x, int y) /* not xchar: perhaps xchar is unsigned and
+                           curx-x would be unsigned as well */
+{
+  enum { MV_CM, MV_REL, MV_CR, MV_LF, MV_HO } how = MV_CM;
+  int best, c;
+
+  if (scr_shadow || headless) { /* MODERN: scr_render() moves the real cursor */
+    curx = (xchar)x;
+    cury = (xchar)y;
+    scr_goto(x, y);
+    return;
+  }
+  if (y == cury && x == curx)
+    return;
+  best = CM ? xcost(tgoto(CM, x - 1, y - 1)) : NOWAY;
+  if ((c = vcost(cury, y) + hcost(curx, x, y)) < best)
+    best = c, how = MV_REL;
+  if ((c = 1 + vcost(cury, y) + hcost(1, x, y)) < best)
+    best = c, how = MV_CR;
+  /* the driver sends each newline as CR LF; without that it is no use */
+  if (y > cury && tty_crmod() && (c = 2 * (y - cury) + hcost(1, x, y)) < best)
+    best = c, how = MV_LF;
+  if ((c = c_HO + vcost(1, y) + hcost(1, x, y)) < best)
+    best = c, how = MV_HO;
+  if (best >= NOWAY) { /* no known way: the 1984 fallbacks */
+    if (CM)
+      cmov(x, y);
+    else
+      nocmov(x, y);
+    return;
+  }
+
+  mv_count++;
+  mv_bytes += best;
+  switch (how) {
+  case MV_CM:
+    cmov(x, y);
+    return;
+  case MV_CR:
+    (void)xputc('\r');
+    curx = 1;
+    break;
+  case MV_LF: /* newline also returns the carriage (ONLCR/CRMOD) */
+    while (cury < y) {
+      (void)xputc('\n');
+      cury++;
+    }
+    curx = 1;
+    break;
+  case MV_HO:
+    xputs(HO);
+    curx = cury = 1;
+    break;
+  case MV_REL:
+    break;
+  }
+  vmove(y);
+  hmove(x);
+}
+
+void prmovestats(void) {
+  pline("Cursor: %ld moves, %ld bytes (%ld per move).", mv_count, mv_bytes,
+        mv_bytes / (mv_count ? mv_count : 1));
+}
+
+#if 0
+/* ORIGINAL 1984 CODE - preserved for reference */
 void curs(int x, int y) /* not xchar: perhaps xchar is unsigned and
                            curx-x would be unsigned as well */
 {
@@ -113,6 +313,7 @@ void curs(int x, int y) /* not xchar: perhaps xchar is unsigned and
   } else
     cmov(x, y);
 }
+#endif /* 0 */
 
 void nocmov(int x, int y) {
   if (cury > y) {
@@ -168,10 +369,126 @@ void cmov(int x, int y) {
 
 int xputc(int c) { return fputc(c, stdout); }
 
-void xputs(char *s) { tputs(s, 1, xputc); }
+void xputs(char *s) {
+  if (!headless)
+    tputs(s, 1, xputc);
+}
+
+/**
+ * MODERN ADDITION (2026): Frame-buffered terminal output
+ *
+ * WHY: Output left the process in whatever pieces stdio happened to cut
+ * (BUFSIZ), and moveloop() only flushed every 7th step of a multi-turn
+ * command. On a server with hundreds of ssh sessions that means bursts of
+ * small writes and runs that advance in visible jerks.
+ *
+ * HOW: hack.main.c gives stdout a FRAMEBUFSZ buffer through frame_open(),
+ * large enough for a complete redraw, so everything a turn produces -
+ * at()/atl() glyphs, bot(), pline() text and the curs() escape sequences -
+ * collects in one contiguous block. flush_frame() hands that block to
+ * write(2) at the end of a turn in moveloop() and before readchar() blocks
+ * for input. Where stdio takes a custom writer (fopencookie() or funopen()),
+ * stdout writes through frame_put(), which counts every write(2) and byte
+ * the game's output costs - those of the remaining fflush(stdout) calls and
+ * of a frame that overflows the buffer included - so #stats reports what
+ * actually went to the terminal. The shadow screen (hack.screen.c) renders
+ * the frame's changes into the buffer first.
+ *
+ * PRESERVES: The order in which output reaches the terminal.
+ * ADDS: A single write per frame and per-frame output counters.
+ */
+#if (defined(HAVE_FOPENCOOKIE) || defined(HAVE_FUNOPEN)) &&                 \
+    defined(HAVE_ASSIGNABLE_STDOUT)
+#define FRAME_COUNTED
+#endif
+
+static long frames, frame_writes, frame_bytes, frame_maxbytes;
+
+#ifdef FRAME_COUNTED
+static long frame_cur; /* bytes written since the last frame ended */
+
+/* stdout's writer: each write(2) of the game's output passes here */
+static long frame_put(const char *buf, long n) {
+  long done = 0, w;
+
+  while (done < n) {
+    if ((w = (long)write(1, buf + done, (size_t)(n - done))) <= 0) {
+      if (w < 0 && (errno == EINTR || errno == EAGAIN))
+        continue;
+      /* an error, or a write of nothing, which would repeat forever */
+      if (!done)
+        return (-1);
+      break;
+    }
+    frame_writes++;
+    done += w;
+  }
+  frame_bytes += done;
+  frame_cur += done;
+  return (done);
+}
+
+#ifdef HAVE_FOPENCOOKIE
+static ssize_t frame_cookie(void *cookie, const char *buf, size_t n) {
+  (void)cookie;
+  return ((ssize_t)frame_put(buf, (long)n));
+}
+#else
+static int frame_cookie(void *cookie, const char *buf, int n) {
+  (void)cookie;
+  return ((int)frame_put(buf, (long)n));
+}
+#endif /* HAVE_FOPENCOOKIE */
+#endif /* FRAME_COUNTED */
+
+/* give stdout the frame buffer buf (FRAMEBUFSZ), counted if stdio allows */
+void frame_open(char *buf) {
+#ifdef FRAME_COUNTED
+#ifdef HAVE_FOPENCOOKIE
+  static cookie_io_functions_t io = {0, frame_cookie, 0, 0};
+  FILE *fp = fopencookie((void *)0, "w", io);
+#else
+  FILE *fp = funopen((void *)0, 0, frame_cookie, 0, 0);
+#endif /* HAVE_FOPENCOOKIE */
+
+  if (fp) {
+    (void)fflush(stdout);
+    stdout = fp;
+  }
+#endif /* FRAME_COUNTED */
+  (void)setvbuf(stdout, buf, _IOFBF, FRAMEBUFSZ);
+}
+
+void flush_frame(void) {
+  scr_render();
+  (void)fflush(stdout);
+#ifdef FRAME_COUNTED
+  if (frame_cur == 0)
+    return; /* nothing left since the last frame */
+  if (frame_cur > frame_maxbytes)
+    frame_maxbytes = frame_cur;
+  frame_cur = 0;
+#endif /* FRAME_COUNTED */
+  frames++;
+}
+
+void prframestats(void) {
+  long f = frames ? frames : 1;
+
+#ifdef FRAME_COUNTED
+  pline("Frames: %ld, writes: %ld (%ld.%02ld per frame).", frames,
+        frame_writes, frame_writes / f, (frame_writes * 100 / f) % 100);
+  pline("Output: %ld bytes, %ld per frame, largest frame %ld.", frame_bytes,
+        frame_bytes / f, frame_maxbytes);
+#else
+  pline("Frames: %ld (writes not counted on this system).", frames);
+#endif /* FRAME_COUNTED */
+}
 
 void cl_end() {
-  if (CE)
+  if (scr_shadow)
+    scr_clreol();
+  else if (CE)
     xputs(CE);
   else { /* no-CE fix - free after Harold Rynes */
     /* this looks terrible, especially on a slow terminal
@@ -187,12 +504,19 @@ void cl_end() {
 }
 
 void clear_screen() {
-  xputs(CL);
+  if (scr_shadow)
+    scr_clear();
+  else {
+    xputs(CL);
+    scr_resume(); /* MODERN: the screen is known again */
+  }
   curx = cury = 1;
 }
 
 void home(void) {
-  if (HO)
+  if (scr_shadow)
+    scr_goto(1, 1);
+  else if (HO)
     xputs(HO);
   else if (CM)
     xputs(tgoto(CM, 0, 0));
@@ -202,23 +526,36 @@ void home(void) {
 }
 
 void standoutbeg() {
-  if (SO)
-    xputs(SO);
+  if (SO) {
+    if (scr_shadow)
+      scr_standout(1);
+    else
+      xputs(SO);
+  }
 }
 
 void standoutend() {
-  if (SE)
-    xputs(SE);
+  if (SE) {
+    if (scr_shadow)
+      scr_standout(0);
+    else
+      xputs(SE);
+  }
 }
 
 void backsp() {
-  xputs(hack_BC);
+  if (scr_shadow)
+    scr_goto(curx - 1, cury);
+  else
+    xputs(hack_BC);
   curx--;
 }
 
 void bell(void) {
+  if (headless)
+    return;
   (void)putchar('\007'); /* curx does not change */
-  (void)fflush(stdout);
+  flush_frame();
 }
 
 static short tmspc10[] __attribute__((unused)) = {/* from termcap */
@@ -247,7 +584,7 @@ static short tmspc10[] __attribute__((unused)) = {/* from termcap */
 int delay_output(int ms) {
   if (ms <= 0)
     return 0;
-  (void)fflush(stdout);
+  flush_frame(); /* show the animation step before sleeping */
   usleep((useconds_t)ms * 1000u);
   return 0; /* success, matching curses library behavior */
 }
@@ -285,7 +622,9 @@ delay_output() {
 void cl_eos(void) /* free after Robert Viduya */
 {                 /* must only be called with curx = 1 */
 
-  if (CD)
+  if (scr_shadow)
+    scr_clreos();
+  else if (CD)
     xputs(CD);
   else {
     int cx = curx, cy = cury;
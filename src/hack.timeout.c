@@ -68,45 +68,178 @@ struct prop *upp;
  * Allows building with curses headers without symbol conflicts.
  */
 void hack_timeout(void) {
-  struct prop *upp;
   if (Stoned)
     stoned_dialogue();
-  for (upp = u.uprops; upp < u.uprops + SIZE(u.uprops); upp++)
-    if ((upp->p_flgs & TIMEOUT) && !--upp->p_flgs) {
-      if (upp->p_tofn)
-        (*upp->p_tofn)();
-      else
-        switch (upp - u.uprops) {
-        case STONED:
-          killer = "cockatrice";
-          done("died");
-          break;
-        case SICK:
-          pline("You die because of food poisoning.");
-          killer = u.usick_cause;
-          done("died");
-          break;
-        case FAST:
-          pline("You feel yourself slowing down.");
-          break;
-        case CONFUSION:
-          pline("You feel less confused now.");
-          break;
-        case BLIND:
-          pline("You can see again.");
-          setsee();
-          break;
-        case INVIS:
-          on_scr(u.ux, u.uy);
-          pline("You are no longer invisible.");
-          break;
-        case WOUNDED_LEGS:
-          heal_legs();
-          break;
-        }
+  run_timers(); /* MODERN: was a countdown of every u.uprops, see below */
+}
+
+/*
+ * MODERN ADDITION (2026): Timed events keyed by moves
+ *
+ * WHY: hack_timeout() looked at every entry of u.uprops each turn to count
+ * down the few - usually none - with a timeout running, and any other
+ * effect with an end would have had to be polled the same way.
+ *
+ * HOW: A binary heap of events, each a turn, a function and an int,
+ * earliest first and ties by the int. timer_at() adds one; hack_timeout()
+ * runs those that are due. While a property's timeout runs, its TIMEOUT
+ * bits hold 1, so tests of Blind, Confusion and the rest read as before,
+ * and utime_at[] holds the turn it ends on. utimeout() gives the turns
+ * left; set_utimeout() and incr_utimeout() replace the assignments to the
+ * counts and queue the end. An event whose property was cured or extended
+ * in the meantime finds another utime_at[] and does nothing. Events are not
+ * saved: dosave0() writes the counts (utimeout_counts()) and dorecover()
+ * queues them again (utimeouts_restored()).
+ *
+ * PRESERVES: Save files; each timeout ends on the same turn, in the same
+ * order and with the same message as when it was counted down.
+ * ADDS: An idle turn costs one look at the heap; later timed effects can
+ * queue their own events with timer_at().
+ */
+struct tevent {
+  long when;
+  int arg;
+  void (*fn)(int arg);
+};
+
+static struct tevent *tq; /* tq[0] is the next one due */
+static int tqlen, tqsize;
+static long utime_at[SIZE(u.uprops)]; /* the turn each timeout ends on */
+
+static boolean tq_before(struct tevent *a, struct tevent *b) {
+  return (a->when < b->when || (a->when == b->when && a->arg < b->arg));
+}
+
+void timer_at(long when, void (*fn)(int arg), int arg) {
+  struct tevent ev;
+  int i, up;
+
+  if (tqlen == tqsize) {
+    tqsize = tqsize ? 2 * tqsize : 16;
+    tq = (struct tevent *)enlarge((char *)tq,
+                                  (unsigned)(tqsize * sizeof(struct tevent)));
+  }
+  ev.when = when;
+  ev.arg = arg;
+  ev.fn = fn;
+  for (i = tqlen++; i > 0 && tq_before(&ev, &tq[up = (i - 1) / 2]); i = up)
+    tq[i] = tq[up];
+  tq[i] = ev;
+}
+
+/* take tq[0] off the heap */
+static void tq_pop(void) {
+  struct tevent last = tq[--tqlen];
+  int i = 0, c;
+
+  while ((c = 2 * i + 1) < tqlen) {
+    if (c + 1 < tqlen && tq_before(&tq[c + 1], &tq[c]))
+      c++;
+    if (!tq_before(&tq[c], &last))
+      break;
+    tq[i] = tq[c];
+    i = c;
+  }
+  tq[i] = last;
+}
+
+void run_timers(void) {
+  struct tevent ev;
+
+  while (tqlen && tq[0].when <= moves) {
+    ev = tq[0];
+    tq_pop();
+    (*ev.fn)(ev.arg);
+  }
+}
+
+/* the end of a property's timeout, as the 1984 countdown reached zero */
+static void utimeout_end(int prop) {
+  struct prop *upp = &u.uprops[prop];
+
+  if (!(upp->p_flgs & TIMEOUT) || utime_at[prop] != moves)
+    return; /* cured or extended since */
+  if (--upp->p_flgs)
+    return; /* a ring or an intrinsic keeps it */
+  if (upp->p_tofn)
+    (*upp->p_tofn)();
+  else
+    switch (prop) {
+    case STONED:
+      killer = "cockatrice";
+      done("died");
+      break;
+    case SICK:
+      pline("You die because of food poisoning.");
+      killer = u.usick_cause;
+      done("died");
+      break;
+    case FAST:
+      pline("You feel yourself slowing down.");
+      break;
+    case CONFUSION:
+      pline("You feel less confused now.");
+      break;
+    case BLIND:
+      pline("You can see again.");
+      setsee();
+      break;
+    case INVIS:
+      on_scr(u.ux, u.uy);
+      pline("You are no longer invisible.");
+      break;
+    case WOUNDED_LEGS:
+      heal_legs();
+      break;
     }
 }
 
+/* turns left on prop's timeout; 0 if none runs */
+long utimeout(int prop) {
+  long left;
+
+  if (!(u.uprops[prop].p_flgs & TIMEOUT))
+    return (0);
+  left = utime_at[prop] - moves + 1;
+  return (left > 0 ? left : 1);
+}
+
+/* prop times out n turns from now, or no longer if n <= 0 */
+void set_utimeout(int prop, long n) {
+  u.uprops[prop].p_flgs &= ~TIMEOUT;
+  if (n <= 0)
+    return;
+  if (n > TIMEOUT)
+    n = TIMEOUT; /* the count could not hold more */
+  u.uprops[prop].p_flgs |= 1;
+  utime_at[prop] = moves + n - 1;
+  timer_at(utime_at[prop], utimeout_end, prop);
+}
+
+void incr_utimeout(int prop, long n) {
+  set_utimeout(prop, utimeout(prop) + n);
+}
+
+/* uprops with the turns left in their TIMEOUT bits, for the save file */
+void utimeout_counts(struct prop *uprops) {
+  int i;
+
+  for (i = 0; i < SIZE(u.uprops); i++)
+    if (uprops[i].p_flgs & TIMEOUT)
+      uprops[i].p_flgs = (uprops[i].p_flgs & ~TIMEOUT) | utimeout(i);
+}
+
+/* u.uprops came from a save file with counts: queue their ends again */
+void utimeouts_restored(void) {
+  long n;
+  int i;
+
+  tqlen = 0;
+  for (i = 0; i < SIZE(u.uprops); i++)
+    if ((n = u.uprops[i].p_flgs & TIMEOUT))
+      set_utimeout(i, n);
+}
+
 /* He is being petrified - dialogue by inmet!tower */
 /* MODERN: CONST-CORRECTNESS: petrification message strings are read-only */
 const char *const stoned_texts[] = {
@@ -118,7 +251,7 @@ const char *const stoned_texts[] = {
 };
 
 void stoned_dialogue(void) {
-  long i = (Stoned & TIMEOUT);
+  long i = utimeout(STONED); /* MODERN: was (Stoned & TIMEOUT) */
 
   if (i > 0 && i <= SIZE(stoned_texts))
     pline(stoned_texts[SIZE(stoned_texts) - i]);
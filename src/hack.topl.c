@@ -392,7 +392,7 @@ void putsym(char c) {
     else
       curx++;
   }
-  (void)putchar(c);
+  scr_putc(c); /* MODERN: was (void) putchar(c); */
 }
 
 void
@@ -35,8 +35,8 @@ struct trap *maketrap(int x, int y, int typ) {
   ttmp->once = 0;
   ttmp->tx = x;
   ttmp->ty = y;
-  ttmp->ntrap = ftrap;
-  ftrap = ttmp;
+  trap_link(ttmp);
+  place_trap(ttmp); /* MODERN: occupancy grid, see hack.grid.c */
   return (ttmp);
 }
 
@@ -373,11 +373,11 @@ void placebc(int attach) {
   uball->ox = uchain->ox = u.ux;
   uball->oy = uchain->oy = u.uy;
   if (attach) {
-    uchain->nobj = fobj;
-    fobj = uchain;
+    obj_link(&fobj, uchain);
+    place_object(uchain, u.ux, u.uy); /* MODERN: occupancy grid */
     if (!carried(uball)) {
-      uball->nobj = fobj;
-      fobj = uball;
+      obj_link(&fobj, uball);
+      place_object(uball, u.ux, u.uy);
     }
   }
 }
@@ -178,6 +178,12 @@ extern void setioctls(void);
  * Called by startup() in termcap.c and after returning from ! or ^Z
  */
 void gettty(void) {
+  if (headless) { /* MODERN: no terminal to ask, see hack.termcap.c */
+    erase_char = '\b';
+    kill_char = 21; /* Ctrl-U */
+    settty_needed = TRUE;
+    return;
+  }
   if (GTTY(&inittyb) < 0) {
     /**
      * MODERN ADDITION (2025): Terminal compatibility for modern systems
@@ -222,11 +228,15 @@ void gettty(void) {
 void
 /* MODERN: CONST-CORRECTNESS: settty message is read-only */
 settty(const char *s) {
+  if (headless)
+    scr_text(); /* MODERN: the last screen of a scripted game */
   clear_screen();
   end_screen();
   if (s)
     printf("%s", s);
   (void)fflush(stdout);
+  if (headless)
+    return;
   if (STTY(&inittyb) < 0) {
     /**
      * MODERN ADDITION (2025): Terminal restoration compatibility
@@ -250,16 +260,31 @@ settty(const char *s) {
 }
 
 void setctty(void) {
+  if (headless)
+    return;
   if (STTY(&curttyb) < 0)
     perror("Hack (setctty)");
 }
 
+/* MODERN: does the driver send '\n' as CR LF? see curs() in hack.termcap.c */
+boolean tty_crmod(void) {
+#if defined(MODERN_TERMIOS) || defined(USG)
+  return ((curttyb.c_oflag & (OPOST | ONLCR)) == (OPOST | ONLCR));
+#else
+  return ((curttyb.sg_flags & CRMOD) != 0);
+#endif
+}
+
 void setftty(void) {
   int ef = 0;                /* desired value of flags & ECHO */
   int cf = CBRKON(CBRKMASK); /* desired value of flags & CBREAK */
   int change = 0;
   flags.cbreak = ON;
   flags.echo = OFF;
+  if (headless) {
+    start_screen();
+    return;
+  }
   /* Should use (ECHO|CRMOD) here instead of ECHO */
   if ((curttyb.echoflgs & ECHO) !=
       (unsigned int)ef) { /* MODERN: Cast to unsigned for flag comparison */
@@ -314,8 +339,8 @@ void getlin(char *bufp) {
 
   flags.toplin = 2; /* nonempty, no --More-- required */
   for (;;) {
-    (void)fflush(stdout);
-    if ((c = getchar()) == EOF) {
+    flush_frame(); /* MODERN: was (void) fflush(stdout); */
+    if ((c = jr_getchar()) == EOF) { /* MODERN: journaled */
       *bufp = 0;
       return;
     }
@@ -400,6 +425,8 @@ char *parse(void) {
     curs_on_u();
   else
     home();
+  flush_frame(); /* MODERN: show the turn, then make the level below */
+  pregen_idle(); /* meanwhile, see hack.lev.c */
   while ((foo = readchar()) >= '0' && foo <= '9')
     multi = 10 * multi + foo - '0';
   if (multi) {
@@ -409,16 +436,16 @@ char *parse(void) {
   inputline[0] = (char)foo; /* MODERN: cast int to char */
   inputline[1] = 0;
   if (foo == 'f' || foo == 'F') {
-    inputline[1] = (char)getchar(); /* MODERN: cast int to char */
+    inputline[1] = (char)jr_getchar(); /* MODERN: cast int to char */
 #ifdef QUEST
     if (inputline[1] == foo)
-      inputline[2] = (char)getchar(); /* MODERN: cast int to char */
+      inputline[2] = (char)jr_getchar(); /* MODERN: cast int to char */
     else
 #endif /* QUEST */
       inputline[2] = 0;
   }
   if (foo == 'm' || foo == 'M') {
-    inputline[1] = (char)getchar(); /* MODERN: cast int to char */
+    inputline[1] = (char)jr_getchar(); /* MODERN: cast int to char */
     inputline[2] = 0;
   }
   clrlin();
@@ -428,8 +455,8 @@ char *parse(void) {
 char readchar(void) {
   int sym;
 
-  (void)fflush(stdout);
-  if ((sym = getchar()) == EOF)
+  flush_frame(); /* MODERN: was (void) fflush(stdout); */
+  if ((sym = jr_getchar()) == EOF) /* MODERN: journaled, see hack.journal.c */
 #ifdef NR_OF_EOFS
   { /*
      * Some SYSV systems seem to return EOFs for various reasons
@@ -439,7 +466,7 @@ char readchar(void) {
     int cnt = NR_OF_EOFS;
     while (cnt--) {
       clearerr(stdin); /* omit if clearerr is undefined */
-      if ((sym = getchar()) != EOF)
+      if ((sym = jr_getchar()) != EOF)
         goto noteof;
     }
     end_of_input();
@@ -13,7 +13,7 @@
 
 /*
  * The time is used for:
- *	- seed for random()
+ *	- seed for the random streams (rnd.c)
  *	- year on tombstone and yymmdd in record file
  *	- phase of the moon (various monsters react to NEW_MOON or FULL_MOON)
  *	- night and midnight (the undead are dangerous at midnight)
@@ -94,23 +94,19 @@ static uint32_t secure_seed(void) {
  * predictable. Modern systems need cryptographically secure seeding for game
  * integrity.
  *
- * HOW: Uses feature detection to choose best available seeding method:
- * srandomdev() on BSD systems, secure_seed() fallback on others.
+ * HOW: Seeds the game's own generator (rnd.c) from secure_seed(), the best
+ * entropy source found at build time.
  *
- * PRESERVES: Same srandom() interface as original 1984 implementation
+ * PRESERVES: setrandom() is still called once at startup
  * ADDS: Secure entropy sources (arc4random, getentropy) for unpredictable seeds
  */
-static void seed_prng(void) {
-#ifdef HAVE_SRANDOMDEV
-  srandomdev();
-#else
-  uint32_t seed = secure_seed();
-  srandom(seed);
-#endif
-}
+static void seed_prng(void) { rnd_seed(secure_seed()); }
 
 void setrandom(void) { seed_prng(); }
 
+/* MODERN ADDITION (2026): a seed to write down, see jr_start() */
+unsigned newseed(void) { return (unsigned)secure_seed(); }
+
 struct tm *getlt(void) {
   time_t date;
 
@@ -118,7 +114,9 @@ struct tm *getlt(void) {
   return (localtime(&date));
 }
 
-int getyear(void) { return (1900 + getlt()->tm_year); }
+/* MODERN: the clock values the game sees go through jr_clock(), so that a
+   replay (hack.journal.c) sees the ones of the recorded game */
+int getyear(void) { return jr_clock('Y', 1900 + getlt()->tm_year); }
 
 char *getdatestr(void) {
   static char datestr[32]; /* MODERN: Buffer increased to handle worst-case
@@ -144,16 +142,16 @@ int phase_of_the_moon(void) /* 0-7, with 0: new, 4: full */
   if ((epact == 25 && golden > 11) || epact == 24)
     epact++;
 
-  return ((((((diy + epact) * 6) + 11) % 177) / 22) & 7);
+  return jr_clock('M', (((((diy + epact) * 6) + 11) % 177) / 22) & 7);
 }
 
 int night(void) {
   int hour = getlt()->tm_hour;
 
-  return (hour < 6 || hour > 21);
+  return jr_clock('N', hour < 6 || hour > 21);
 }
 
-int midnight(void) { return (getlt()->tm_hour == 0); }
+int midnight(void) { return jr_clock('O', getlt()->tm_hour == 0); }
 
 struct stat buf, hbuf;
 
@@ -499,6 +497,7 @@ void mdrush(struct monst *md, boolean away) {
     tmp_at(-1, md->data->mlet); /* open call */
     if (away) {                 /* interchange origin and destination */
       unpmon(md);
+      remove_monster(md); /* MODERN: off the grid for the run; it dies next */
       tmp = fx;
       fx = md->mx;
       md->mx = tmp;
@@ -525,10 +524,8 @@ void mdrush(struct monst *md, boolean away) {
         fx = nfx;
         fy = nfy;
       } else {
-        if (!away) {
-          md->mx = fx;
-          md->my = fy;
-        }
+        if (!away) /* MODERN: was md->mx = fx, md->my = fy */
+          place_monster(md, fx, fy);
         break;
       }
     }
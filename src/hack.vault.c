@@ -9,6 +9,9 @@ int gd_move(void) { return (2); }
 void gddead(struct monst *mtmp) {}
 void replgd(struct monst *mtmp, struct monst *mtmp2) {}
 void invault(void) {}
+unsigned egd_size(void) { return (0); }
+void egd_image(struct limg *w, struct monst *mtmp) {}
+void egd_unimage(struct lrd *r, struct monst *mtmp) {}
 
 #else
 
@@ -26,7 +29,8 @@ struct egd {
   struct fakecorridor fakecorr[FCSIZ];
 };
 
-static struct permonst pm_guard = {"guard", '@', 12, 12,
+/* MODERN: not static, level images name it (hack.levimg.c) */
+struct permonst pm_guard = {"guard", '@', 12, 12,
                                    -1,      4,   10, sizeof(struct egd)};
 
 static struct monst *guard;
@@ -272,8 +276,7 @@ proceed:
 newpos:
   if (EGD->gddone)
     nx = ny = 0;
-  guard->mx = nx;
-  guard->my = ny;
+  place_monster(guard, nx, ny); /* MODERN: was mx = nx, my = ny */
   pmon(guard);
   restfakecorr();
   return (1);
@@ -286,4 +289,39 @@ void replgd(struct monst *mtmp, struct monst *mtmp2) {
     guard = mtmp2;
 }
 
+/* MODERN: a guard's struct egd in a level image (hack.levimg.c) */
+unsigned egd_size(void) { return (sizeof(struct egd)); }
+
+void egd_image(struct limg *w, struct monst *mtmp) {
+  struct egd *egd = (struct egd *)(void *)&mtmp->mextra[0];
+  int i;
+
+  li_put(w, (unsigned long)egd->fcbeg, 4);
+  li_put(w, (unsigned long)egd->fcend, 4);
+  li_put(w, (uchar)egd->gdx, 1);
+  li_put(w, (uchar)egd->gdy, 1);
+  li_put(w, egd->gddone, 1);
+  for (i = 0; i < FCSIZ; i++) {
+    li_put(w, (uchar)egd->fakecorr[i].fx, 1);
+    li_put(w, (uchar)egd->fakecorr[i].fy, 1);
+    li_put(w, (uchar)egd->fakecorr[i].ftyp, 1);
+  }
+}
+
+void egd_unimage(struct lrd *r, struct monst *mtmp) {
+  struct egd *egd = (struct egd *)(void *)&mtmp->mextra[0];
+  int i;
+
+  egd->fcbeg = (int)li_get(r, 4);
+  egd->fcend = (int)li_get(r, 4);
+  egd->gdx = (xchar)li_get(r, 1);
+  egd->gdy = (xchar)li_get(r, 1);
+  egd->gddone = (unsigned)li_get(r, 1) & 1;
+  for (i = 0; i < FCSIZ; i++) {
+    egd->fakecorr[i].fx = (xchar)li_get(r, 1);
+    egd->fakecorr[i].fy = (xchar)li_get(r, 1);
+    egd->fakecorr[i].ftyp = (xchar)li_get(r, 1);
+  }
+}
+
 #endif /* QUEST */
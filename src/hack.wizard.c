@@ -53,8 +53,7 @@ int wiz_hit(struct monst *mtmp) {
             isok(otmp->ox, otmp->oy) && !m_at(otmp->ox, otmp->oy)) { /* MODERN: bounds check prevents invalid teleportation coordinates */
 
           /* teleport to it and pick it up */
-          mtmp->mx = otmp->ox;
-          mtmp->my = otmp->oy;
+          place_monster(mtmp, otmp->ox, otmp->oy); /* MODERN: was mx,my = */
           freeobj(otmp);
           mpickobj(mtmp, otmp);
           pmon(mtmp);
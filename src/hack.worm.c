@@ -47,6 +47,7 @@ void worm_move(struct monst *mtmp) {
   if (!whd) return; /* MODERN: null check prevents crash on corrupted worm head */
   whd->nseg = wtmp;
   wheads[tmp] = wtmp;
+  place_wseg(whd, mtmp); /* MODERN: the old head square is tail now */
   if (cansee(whd->wx, whd->wy)) {
     unpmon(mtmp);
     atl(whd->wx, whd->wy, '~');
@@ -177,10 +178,11 @@ void cutworm(struct monst *mtmp, xchar x, xchar y,
       if (tmp2) {
         pline("You cut the worm in half.");
         mtmp2->mhpmax = mtmp2->mhp = (schar)d(mtmp2->data->mlevel, 8); /* MODERN: Safe cast - HP bounded by dice */
-        mtmp2->mx = wtmp->wx;
-        mtmp2->my = wtmp->wy;
-        mtmp2->nmon = fmon;
-        fmon = mtmp2;
+        link_monster(mtmp2); /* MODERN: was mtmp2->nmon = fmon, fmon = mtmp2 */
+        /* MODERN: was mx = wtmp->wx, my = wtmp->wy; the tail half takes
+           over its squares in the occupancy grid */
+        place_monster(mtmp2, wtmp->wx, wtmp->wy);
+        place_worm(mtmp2);
         pmon(mtmp2);
       } else {
         pline("You cut off part of the worm's tail.");
@@ -201,8 +203,9 @@ void cutworm(struct monst *mtmp, xchar x, xchar y,
 void remseg(struct wseg *wtmp) {
   if (!wtmp)
     return; /* MODERN: defensive check against null segment */
+  remove_wseg(wtmp); /* MODERN: occupancy grid */
   if (wtmp->wdispl)
     newsym(wtmp->wx, wtmp->wy);
-  free((char *)wtmp);
+  lfree((char *)wtmp);
 }
 #endif /* NOWORM */
@@ -635,8 +635,8 @@ void rloco(struct obj *obj) {
     tx = rn1(COLNO - 3, 2);
     ty = rn2(ROWNO);
   } while (!goodpos(tx, ty));
-  obj->ox = tx;
-  obj->oy = ty;
+  remove_object(obj); /* MODERN: was obj->ox = tx; obj->oy = ty; */
+  place_object(obj, tx, ty);
   if (cansee(otx, oty))
     newsym(otx, oty);
 }
@@ -8,11 +8,14 @@
  * Key modernizations: ANSI C function signatures
  */
 
-#include <stdlib.h>
+#include "hack.h"
+#include <stdint.h>
+#include <string.h>
 
+#if 0
+/* ORIGINAL 1984 CODE - preserved for reference */
 #define RND(x) (random() % x)
 
-/* MODERN: K&R to ANSI C conversion - function signatures only */
 int rn1(int x, int y) { return (RND(x) + y); }
 
 int rn2(int x) { return (RND(x)); }
@@ -26,3 +29,176 @@ int d(int n, int x) {
     tmp += RND(x);
   return (tmp);
 }
+#endif
+
+/**
+ * MODERN ADDITION (2026): Own generator with one stream per subsystem
+ *
+ * WHY: random() % x takes the libc lock on every call, favours low results
+ * whenever x does not divide 2^31, and is one stream for the whole game: a
+ * single extra rn2() in a fight shifted every level generated after it.
+ *
+ * HOW: xoshiro128** (Blackman and Vigna), four 32-bit words of state per
+ * stream. rnd_seed() derives every stream from one game seed with
+ * splitmix64. mklev(), mkobj()/mksobj(), makemon()/movemon() and the fight
+ * code switch to their stream with rnd_use() on entry and back on return,
+ * so calls nest: an object made while generating a level comes from the
+ * item stream. Everything else draws from RS_MISC. rn2(x) maps a 32-bit
+ * draw onto 0..x-1 by multiplication, rejecting the few draws that would
+ * make some results more likely (Lemire), so no division on the usual path.
+ *
+ * PRESERVES: rn1(), rn2(), rnd() and d() ranges and signatures.
+ * ADDS: No lock or modulo bias per call; a subsystem's call count changes
+ * only its own stream.
+ */
+#define RS_WORDS 4
+
+static uint32_t rs_state[RS_NSTREAMS][RS_WORDS] = {
+    {1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}, {13, 14, 15, 16},
+    {17, 18, 19, 20}};
+static uint32_t *rs = rs_state[RS_MISC];
+static int rs_cur = RS_MISC;
+static unsigned rs_game;                           /* the game seed */
+static uint32_t rs_game_state[RS_NSTREAMS][RS_WORDS]; /* during mklev() */
+
+static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+static uint32_t rs_next(void) {
+  uint32_t *s = rs;
+  uint32_t res = rotl(s[1] * 5, 7) * 9, t = s[1] << 9;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 11);
+  return (res);
+}
+
+/* 0..x-1, every value equally likely; x > 0 */
+static int rs_below(uint32_t x) {
+  uint64_t m = (uint64_t)rs_next() * x;
+  uint32_t l = (uint32_t)m, t;
+
+  if (l < x) {
+    t = (uint32_t)(-x) % x;
+    while (l < t) {
+      m = (uint64_t)rs_next() * x;
+      l = (uint32_t)m;
+    }
+  }
+  return ((int)(m >> 32));
+}
+
+static uint64_t splitmix64(uint64_t *x) {
+  uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return (z ^ (z >> 31));
+}
+
+/* one stream from the game seed and a key naming it */
+static void rs_init(uint32_t *s, uint64_t key) {
+  uint64_t a = splitmix64(&key), b = splitmix64(&key);
+
+  s[0] = (uint32_t)a;
+  s[1] = (uint32_t)(a >> 32);
+  s[2] = (uint32_t)b;
+  s[3] = (uint32_t)(b >> 32);
+  if (!(s[0] | s[1] | s[2] | s[3]))
+    s[0] = 1; /* the all-zero state never leaves zero */
+}
+
+void rnd_seed(unsigned seed) {
+  int i;
+
+  rs_game = seed;
+  for (i = 0; i < RS_NSTREAMS; i++)
+    rs_init(rs_state[i], ((uint64_t)seed << 8) | (uint64_t)i);
+}
+
+/* the game seed, for the save file */
+unsigned rnd_game(void) { return (rs_game); }
+
+/* a restored game makes its new levels from the seed it started with */
+void rnd_setgame(unsigned seed) { rs_game = seed; }
+
+/**
+ * MODERN ADDITION (2026): Levels made from the game seed and their depth
+ *
+ * WHY: mklev() drew from the streams the game had been using, so level N
+ * depended on every roll made before the player got there. The same seed
+ * did not give the same dungeon, and a level could not be made ahead of
+ * time or compared between runs.
+ *
+ * HOW: rnd_level() puts the game's streams aside and gives every stream a
+ * fresh start from (game seed, level, stream), then draws from RS_LEVEL;
+ * objects and monsters placed on the level still come from their own
+ * streams. rnd_level_end() brings the game's streams back exactly as they
+ * were.
+ *
+ * PRESERVES: What mklev() does and how often it rolls.
+ * ADDS: A level depends only on the seed, its depth and the little the
+ * generator reads of the game (genocides, whether the Amulet was made);
+ * making a level no longer moves the game's streams.
+ */
+int rnd_level(int lev) {
+  int i;
+
+  (void)memcpy(rs_game_state, rs_state, sizeof(rs_state));
+  for (i = 0; i < RS_NSTREAMS; i++)
+    rs_init(rs_state[i], ((uint64_t)rs_game << 8) | (uint64_t)i |
+                             ((uint64_t)(unsigned)lev << 40));
+  return (rnd_use(RS_LEVEL));
+}
+
+void rnd_level_end(int stream) {
+  (void)memcpy(rs_state, rs_game_state, sizeof(rs_state));
+  (void)rnd_use(stream);
+}
+
+/* draw from stream from now on; returns the stream drawn from until now */
+int rnd_use(int stream) {
+  int old = rs_cur;
+
+  rs_cur = stream;
+  rs = rs_state[stream];
+  return (old);
+}
+
+/* a summary of where every stream is, for comparing runs */
+unsigned long rnd_state(void) {
+  unsigned long h = 5381;
+  int i, j;
+
+  for (i = 0; i < RS_NSTREAMS; i++)
+    for (j = 0; j < RS_WORDS; j++)
+      h = h * 33 + rs_state[i][j];
+  return (h);
+}
+
+int rn1(int x, int y) { return (rn2(x) + y); }
+
+int rn2(int x) { return (x > 0 ? rs_below((uint32_t)x) : 0); }
+
+int rnd(int x) { return (rn2(x) + 1); }
+
+/* n dice in one loop: x's rejection bound is worked out once for all */
+int d(int n, int x) {
+  uint32_t ux = (uint32_t)x, t;
+  uint64_t m;
+  int tmp = n;
+
+  if (x <= 0)
+    return (n);
+  t = (uint32_t)(-ux) % ux;
+  while (n-- > 0) {
+    do
+      m = (uint64_t)rs_next() * ux;
+    while ((uint32_t)m < t);
+    tmp += (int)(m >> 32);
+  }
+  return (tmp);
+}